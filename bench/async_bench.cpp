@@ -0,0 +1,90 @@
+// End-to-end latency of fold_as_ready and async_foldt on 8 operations
+// completed by a thread_pool: the first one after a long delay, the others
+// almost immediately, and a slow fn (50 ms per call).
+// fold_as_ready combines the fast operations while the slow one is pending
+// (about delay + 1 call), async_foldt waits for it at each level of its
+// sub-tree (about delay + 3 calls).
+//
+// usage: async_bench [delay-ms=300] [fn-ms=50]
+
+#include <falcon/fold/parallel.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <thread>
+
+
+namespace {
+
+using ms = std::chrono::milliseconds;
+
+/// completed on the pool after a delay
+struct DelayedOp
+{
+  using value_type = int;
+
+  falcon::fold::thread_pool * pool;
+  int value;
+  ms delay;
+
+  template<class Cb>
+  void operator()(Cb cb) {
+    int v = value;
+    auto d = delay;
+    pool->post([cb, v, d]() mutable {
+      std::this_thread::sleep_for(d);
+      cb(v);
+    });
+  }
+};
+
+struct SlowPlus
+{
+  ms delay;
+
+  int operator()(int x, int y) const {
+    std::this_thread::sleep_for(delay);
+    return x + y;
+  }
+};
+
+/// returns the value and the end-to-end latency in milliseconds
+template<class Op>
+std::pair<int, long> run_timed(Op op) {
+  std::promise<int> promise;
+  auto start = std::chrono::steady_clock::now();
+  op([&promise](int x) { promise.set_value(x); });
+  int x = promise.get_future().get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return {x, long(std::chrono::duration_cast<ms>(elapsed).count())};
+}
+
+}
+
+
+int main(int ac, char ** av)
+{
+  ms const delay(ac > 1 ? std::atoi(av[1]) : 300);
+  SlowPlus const f{ms(ac > 2 ? std::atoi(av[2]) : 50)};
+
+  falcon::fold::thread_pool pool(8);
+  auto const as_ready = run_timed(falcon::fold::fold_as_ready(
+    f,
+    DelayedOp{&pool, 1, delay}, DelayedOp{&pool, 2, ms(1)},
+    DelayedOp{&pool, 3, ms(1)}, DelayedOp{&pool, 4, ms(1)},
+    DelayedOp{&pool, 5, ms(1)}, DelayedOp{&pool, 6, ms(1)},
+    DelayedOp{&pool, 7, ms(1)}, DelayedOp{&pool, 8, ms(1)}
+  ));
+  auto const static_tree = run_timed(falcon::fold::async_foldt(
+    f,
+    DelayedOp{&pool, 1, delay}, DelayedOp{&pool, 2, ms(1)},
+    DelayedOp{&pool, 3, ms(1)}, DelayedOp{&pool, 4, ms(1)},
+    DelayedOp{&pool, 5, ms(1)}, DelayedOp{&pool, 6, ms(1)},
+    DelayedOp{&pool, 7, ms(1)}, DelayedOp{&pool, 8, ms(1)}
+  ));
+
+  std::printf("%-16s %6ld ms (result %d)\n", "fold_as_ready", as_ready.second, as_ready.first);
+  std::printf("%-16s %6ld ms (result %d)\n", "async_foldt", static_tree.second, static_tree.first);
+}
@@ -0,0 +1,93 @@
+// Throughput of the folds on a file of uint64_t generated in the current
+// directory: ifstream read by blocks of 1 MiB then range_foldl on each
+// block, fold_file with foldl_tag and foldt_tag, and par_fold_file.
+// The first run of each reads the page cache (the file was just written).
+//
+// usage: file_bench [number-of-elements=134217728] [repetitions=5]
+
+#include <falcon/fold/file.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+
+namespace {
+
+std::uint64_t volatile sink;
+
+char const * const path = "file_bench.bin";
+
+// best of rep runs, after a warm-up
+template<class F>
+void bench(char const * name, std::size_t n, int rep, F f)
+{
+  sink = f();
+  double best = 1e9;
+  for (int i = 0; i < rep; ++i) {
+    auto const start = std::chrono::steady_clock::now();
+    sink = f();
+    auto const stop = std::chrono::steady_clock::now();
+    double const s = std::chrono::duration<double>(stop - start).count();
+    best = s < best ? s : best;
+  }
+  std::printf("%-24s %8.2f GB/s\n", name, double(n * sizeof(std::uint64_t)) / best / 1e9);
+}
+
+void generate(std::size_t n)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  std::vector<std::uint64_t> block(1 << 17);
+  for (std::size_t i = 0; i < n; i += block.size()) {
+    std::size_t const m = n - i < block.size() ? n - i : block.size();
+    for (std::size_t j = 0; j < m; ++j) {
+      block[j] = (i + j) * 0x9E3779B97F4A7C15u;
+    }
+    file.write(reinterpret_cast<char const *>(block.data()),
+               static_cast<std::streamsize>(m * sizeof(std::uint64_t)));
+  }
+}
+
+std::uint64_t ifstream_fold()
+{
+  std::ifstream file(path, std::ios::binary);
+  std::vector<std::uint64_t> block(1 << 17);
+  std::uint64_t r = 0;
+  while (file.read(reinterpret_cast<char *>(block.data()),
+                   static_cast<std::streamsize>(block.size() * sizeof(std::uint64_t)))
+      || file.gcount()) {
+    auto const m = static_cast<std::size_t>(file.gcount()) / sizeof(std::uint64_t);
+    r += falcon::fold::range_foldl(std::plus<>{}, block.data(), block.data() + m);
+  }
+  return r;
+}
+
+}
+
+
+int main(int ac, char ** av)
+{
+  std::size_t const n = ac > 1 ? std::strtoul(av[1], nullptr, 10) : std::size_t{1} << 27;
+  int const rep = ac > 2 ? std::atoi(av[2]) : 5;
+
+  generate(n);
+  std::printf("%zu uint64_t, %d repetitions\n", n, rep);
+
+  falcon::fold::thread_pool pool;
+
+  bench("ifstream + range_foldl", n, rep, ifstream_fold);
+  bench("fold_file(foldl_tag)", n, rep, []{
+    return falcon::fold::fold_file<std::uint64_t>(path, std::plus<>{});
+  });
+  bench("fold_file(foldt_tag)", n, rep, []{
+    return falcon::fold::fold_file<std::uint64_t>(path, std::plus<>{}, falcon::fold::foldt_tag{});
+  });
+  bench("par_fold_file", n, rep, [&]{
+    return falcon::fold::par_fold_file<std::uint64_t>(pool, path, std::plus<>{});
+  });
+
+  std::remove(path);
+}
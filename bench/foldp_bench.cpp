@@ -0,0 +1,78 @@
+// Throughput of range_foldp with different growth factors and first block
+// sizes on a large buffer of floats (groups folded with range_foldt).
+//
+// usage: foldp_bench [number-of-elements=16777216] [repetitions=10]
+
+#include <falcon/fold/range.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+namespace {
+
+float volatile sink;
+
+// best of rep runs, after a warm-up
+template<class F>
+void bench(char const * name, std::vector<float> const & v, int rep, F f)
+{
+  sink = f(v.data(), v.data() + v.size());
+  double best = 1e9;
+  for (int i = 0; i < rep; ++i) {
+    auto const start = std::chrono::steady_clock::now();
+    sink = f(v.data(), v.data() + v.size());
+    auto const stop = std::chrono::steady_clock::now();
+    double const s = std::chrono::duration<double>(stop - start).count();
+    best = s < best ? s : best;
+  }
+  std::printf("%-24s %8.2f GB/s\n", name,
+              double(v.size() * sizeof(float)) / best / 1e9);
+}
+
+struct Folder
+{
+  float operator()(float const * first, float const * last) const {
+    return falcon::fold::range_foldt(std::plus<>{}, first, last);
+  }
+};
+
+template<std::size_t Factor, std::size_t First>
+void bench_foldp(std::vector<float> const & v, int rep)
+{
+  char name[64];
+  std::snprintf(name, sizeof(name), "range_foldp<%zu, %zu>", Factor, First);
+  bench(name, v, rep, [](float const * first, float const * last) {
+    return falcon::fold::range_foldp<Factor, First>(Folder{}, std::plus<>{}, first, last);
+  });
+}
+
+}
+
+
+int main(int ac, char ** av)
+{
+  std::size_t const n = ac > 1 ? std::strtoul(av[1], nullptr, 10) : std::size_t{1} << 24;
+  int const rep = ac > 2 ? std::atoi(av[2]) : 10;
+
+  std::vector<float> v(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    v[i] = float(i % 1000) / 1000.f;
+  }
+
+  std::printf("%zu floats, %d repetitions\n", n, rep);
+  bench("range_foldl", v, rep, [](float const * first, float const * last) {
+    return falcon::fold::range_foldl(std::plus<>{}, first, last);
+  });
+  bench("range_foldt", v, rep, [](float const * first, float const * last) {
+    return falcon::fold::range_foldt(std::plus<>{}, first, last);
+  });
+  bench_foldp<2, 1>(v, rep);
+  bench_foldp<2, 16>(v, rep);
+  bench_foldp<4, 1>(v, rep);
+  bench_foldp<4, 16>(v, rep);
+  bench_foldp<8, 64>(v, rep);
+  bench_foldp<4, 4096>(v, rep);
+}
@@ -0,0 +1,60 @@
+// Throughput of hash_fold (foldt shape) compared to the serial chain
+// foldl(ops::hash_combine{}, ...) on keys of 16 integers.
+//
+// usage: hash_bench [number-of-keys=1048576] [repetitions=20]
+
+#include <falcon/fold/hash.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+constexpr std::size_t key_size = 16;
+
+std::uint64_t volatile sink;
+
+template<class Tag, std::size_t... I>
+std::uint64_t hash_key(std::uint64_t const * k, std::index_sequence<I...>) {
+  return falcon::hash_fold<Tag>(k[I]...);
+}
+
+template<class Tag>
+void bench(char const * name, std::vector<std::uint64_t> const & v, int rep)
+{
+  std::size_t const n = v.size() / key_size;
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rep; ++i) {
+    std::uint64_t h = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+      h += hash_key<Tag>(v.data() + k * key_size, std::make_index_sequence<key_size>());
+    }
+    sink = h;
+  }
+  auto const stop = std::chrono::steady_clock::now();
+  double const s = std::chrono::duration<double>(stop - start).count();
+  std::printf("%-26s %8.1f Mkeys/s\n", name, double(n) * rep / s / 1e6);
+}
+
+}
+
+
+int main(int ac, char ** av)
+{
+  std::size_t const n = ac > 1 ? std::strtoul(av[1], nullptr, 10) : std::size_t{1} << 20;
+  int const rep = ac > 2 ? std::atoi(av[2]) : 20;
+
+  std::mt19937_64 gen(42);
+  std::vector<std::uint64_t> v(n * key_size);
+  for (auto & x : v) {
+    x = gen();
+  }
+
+  std::printf("%zu keys of %zu integers, %d repetitions\n", n, key_size, rep);
+  bench<falcon::fold::foldl_tag>("hash_fold<foldl_tag>", v, rep);
+  bench<falcon::fold::foldt_tag>("hash_fold<foldt_tag>", v, rep);
+}
@@ -0,0 +1,72 @@
+// Throughput and error of ops::kahan_plus compared to std::plus
+// with range_foldl and range_foldt on doubles.
+//
+// usage: kahan_bench [number-of-elements=4194304] [repetitions=20]
+
+#include <falcon/fold/ops.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+double volatile sink;
+
+template<class F>
+void bench(char const * name, std::vector<double> const & v, int rep,
+           long double ref, F f)
+{
+  double x = 0;
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rep; ++i) {
+    x = f(v.data(), v.data() + v.size());
+    sink = x;
+  }
+  auto const stop = std::chrono::steady_clock::now();
+  double const s = std::chrono::duration<double>(stop - start).count();
+  std::printf("%-24s %10.1f Melem/s   error %.3Le\n", name,
+              double(v.size()) * rep / s / 1e6, std::fabs(ref - x));
+}
+
+}
+
+
+int main(int ac, char ** av)
+{
+  std::size_t const n = ac > 1 ? std::strtoul(av[1], nullptr, 10) : std::size_t{1} << 22;
+  int const rep = ac > 2 ? std::atoi(av[2]) : 20;
+
+  // values of different magnitudes and signs: large rounding errors
+  std::mt19937_64 gen(42);
+  std::uniform_real_distribution<double> mantissa(-1., 1.);
+  std::uniform_int_distribution<int> exponent(-20, 20);
+  std::vector<double> v(n);
+  long double ref = 0;
+  for (double & x : v) {
+    x = std::ldexp(mantissa(gen), exponent(gen));
+    ref += x;
+  }
+
+  using falcon::fold::range_foldl;
+  using falcon::fold::range_foldt;
+  using falcon::fold::ops::kahan_plus;
+
+  std::printf("%zu doubles, %d repetitions\n", n, rep);
+  bench("range_foldl(plus)", v, rep, ref, [](double const * first, double const * last) {
+    return range_foldl(std::plus<>{}, first, last);
+  });
+  bench("range_foldt(plus)", v, rep, ref, [](double const * first, double const * last) {
+    return range_foldt(std::plus<>{}, first, last);
+  });
+  bench("range_foldl(kahan_plus)", v, rep, ref, [](double const * first, double const * last) {
+    return range_foldl(kahan_plus{}, first, last).value();
+  });
+  bench("range_foldt(kahan_plus)", v, rep, ref, [](double const * first, double const * last) {
+    return range_foldt(kahan_plus{}, first, last).value();
+  });
+}
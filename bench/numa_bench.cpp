@@ -0,0 +1,88 @@
+// Throughput of the parallel range folds on a large buffer of floats:
+// range_foldt on 1 thread, par_range_foldt on a single thread_pool with the
+// buffer initialized by the main thread, and par_range_foldt on a numa_pool
+// with each part initialized by its node (first-touch placement).
+// On a single-node box, the last two are close.
+//
+// usage: numa_bench [number-of-elements=268435456] [repetitions=5]
+
+#include <falcon/fold/numa.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+
+namespace {
+
+float volatile sink;
+
+// best of rep runs, after a warm-up
+template<class F>
+void bench(char const * name, float const * p, std::size_t n, int rep, F f)
+{
+  sink = f(p, p + n);
+  double best = 1e9;
+  for (int i = 0; i < rep; ++i) {
+    auto const start = std::chrono::steady_clock::now();
+    sink = f(p, p + n);
+    auto const stop = std::chrono::steady_clock::now();
+    double const s = std::chrono::duration<double>(stop - start).count();
+    best = s < best ? s : best;
+  }
+  std::printf("%-32s %8.2f GB/s\n", name, double(n * sizeof(float)) / best / 1e9);
+}
+
+// not value-initialized: the pages are placed by the first write
+std::unique_ptr<float[]> make_buffer(std::size_t n)
+{
+  return std::unique_ptr<float[]>(new float[n]);
+}
+
+void fill(float * first, float * last)
+{
+  for (float * p = first; p != last; ++p) {
+    *p = float((p - first) % 1000) / 1000.f;
+  }
+}
+
+}
+
+
+int main(int ac, char ** av)
+{
+  std::size_t const n = ac > 1 ? std::strtoul(av[1], nullptr, 10) : std::size_t{1} << 28;
+  int const rep = ac > 2 ? std::atoi(av[2]) : 5;
+
+  falcon::fold::numa_pool numa;
+  std::size_t threads = 0;
+  for (std::size_t i = 0; i < numa.size(); ++i) {
+    auto const & node = numa.node(i);
+    std::printf("node %u: %zu cpus\n", node.id, node.cpus.size());
+    threads += node.cpus.empty() ? 0 : node.cpus.size();
+  }
+  falcon::fold::thread_pool pool(threads ? threads : std::thread::hardware_concurrency());
+  std::printf("%zu floats, %d repetitions\n", n, rep);
+
+  {
+    auto const buf = make_buffer(n);
+    fill(buf.get(), buf.get() + n);
+    bench("range_foldt", buf.get(), n, rep, [](float const * first, float const * last) {
+      return falcon::fold::range_foldt(std::plus<>{}, first, last);
+    });
+    bench("par_range_foldt(thread_pool)", buf.get(), n, rep, [&](float const * first, float const * last) {
+      return falcon::fold::par_range_foldt(pool, std::plus<>{}, first, last);
+    });
+  }
+
+  {
+    auto const buf = make_buffer(n);
+    numa.for_each_part(buf.get(), buf.get() + n, [](std::size_t, float * first, float * last) {
+      fill(first, last);
+    });
+    bench("par_range_foldt(numa_pool)", buf.get(), n, rep, [&](float const * first, float const * last) {
+      return falcon::fold::par_range_foldt(numa, std::plus<>{}, first, last);
+    });
+  }
+}
@@ -0,0 +1,49 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     C++20 module interface unit of falcon/fold.hpp: \c import \c falcon.fold;
+ *
+ * The header is exported and attached to the global module
+ * (\c extern \c "C++"): the names are the same as with \c #include,
+ * without the macros. The standard headers are included in the global
+ * module fragment, before the module declaration.
+ */
+
+module;
+
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#if defined(FALCON_FOLD_USE_BRIGAND) && FALCON_FOLD_USE_BRIGAND
+# include <brigand/brigand.hpp>
+#endif
+
+export module falcon.fold;
+
+export extern "C++" {
+#include <falcon/fold.hpp>
+}
@@ -24,7 +24,7 @@ SOFTWARE.
 /**
  * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
  * \version   1.0
- * \brief     Fold functions on parameter list: foldl, foldr, foldbl, foldbr, foldt and foldp.
+ * \brief     Fold functions on parameter list: foldl, foldr, foldbl, foldbr, foldt, foldtree and foldp.
  *
  * `f`: Binary function. If no element in a fold, is used as a generator (cf: `f()`)
  * `Ts... args`: list of values
@@ -35,16 +35,153 @@ SOFTWARE.
 #ifndef FALCON_FOLD_HPP
 #define FALCON_FOLD_HPP
 
+#include <tuple>
 #include <utility>
-#include <algorithm> // std:min, std::max
 #include <type_traits>
 
-#include <brigand/brigand.hpp>
+/// Use brigand (https://github.com/edouarda/brigand) for the type lists
+#ifndef FALCON_FOLD_USE_BRIGAND
+# define FALCON_FOLD_USE_BRIGAND 0
+#endif
+
+#if FALCON_FOLD_USE_BRIGAND
+# include <brigand/brigand.hpp>
+#endif
+
+#ifndef FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS
+# if defined(__cpp_fold_expressions) && __cpp_fold_expressions >= 201411
+#  define FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS 1
+# else
+#  define FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS 0
+# endif
+#endif
+
+#if defined(__cpp_inline_variables) && __cpp_inline_variables >= 201606
+# define FALCON_FOLD_INLINE_VARIABLE inline
+#else
+# define FALCON_FOLD_INLINE_VARIABLE
+#endif
 
-#include <falcon/cxx/cxx.hpp>
+/// Homogeneous packs are folded by a runtime loop (one instantiation per type and function, not per arity)
+#ifndef FALCON_FOLD_OPTIMIZE_SIZE
+# define FALCON_FOLD_OPTIMIZE_SIZE 0
+#endif
+
+/// From this number of arguments, the packs are folded at runtime (bounded compile time).
+/// The heterogeneous packs are then folded on leaves converted to the result type (see README)
+#ifndef FALCON_FOLD_ERASURE_THRESHOLD
+# define FALCON_FOLD_ERASURE_THRESHOLD 1024
+#endif
 
 
 namespace falcon {
+
+namespace detail { namespace fold {
+  using std::size_t;
+
+#if defined(_MSC_VER) or defined(__clang__)
+  constexpr size_t
+  count_foldt_element2(size_t count, size_t pow = 1)
+  {
+    return pow == sizeof(size_t) * 8
+      ? count
+      : count_foldt_element2(count | (count >> pow), pow * 2);
+  }
+
+  constexpr size_t
+  count_foldt_element(size_t count)
+  {
+    return (count <= 2)
+      ? count
+      : (count_foldt_element2(count - 1) + 1) / 2;
+  }
+#else
+  constexpr size_t
+  count_foldt_element(size_t count)
+  {
+    return (count <= 2)
+      ? count
+      : (
+        count -= 1,
+        count |= (count >> 1),
+        count |= (count >> 2),
+        count |= (count >> 4),
+        count |= (count >> 8),
+        count |= (count >> 16),
+        count |= (count >> 16 >> 16),
+        count += 1,
+        count / 2
+      );
+  }
+#endif
+
+  template<class... Ts>
+  struct type_pack;
+
+  template<class... Ts>
+  struct make_void
+  { using type = void; };
+
+  template<class Fn, class T, class U>
+  using call_result_t = std::decay_t<decltype(std::declval<Fn&>()(std::declval<T>(), std::declval<U>()))>;
+
+  /// \c R when \a Fn is closed on \c R: f(T, T), f(R, T), f(T, R) and f(R, R) return a \c R
+  template<class Fn, class T, class R = std::decay_t<T>, class = void>
+  struct homogeneous_result
+  {};
+
+  template<class Fn, class T, class R>
+  struct homogeneous_result<Fn, T, R, typename make_void<
+    call_result_t<Fn, T, T>, call_result_t<Fn, R, T>,
+    call_result_t<Fn, T, R>, call_result_t<Fn, R, R>
+  >::type>
+  : std::enable_if<std::is_same<
+    type_pack<call_result_t<Fn, T, T>, call_result_t<Fn, R, T>,
+              call_result_t<Fn, T, R>, call_result_t<Fn, R, R>>,
+    type_pack<R, R, R, R>
+  >::value, R>
+  {};
+
+  /// \c R when \a T and \a Ts are the same type (value category included)
+  template<class Fn, class T, class... Ts>
+  using homogeneous_fold_t = typename std::enable_if<
+    std::is_same<type_pack<T, Ts...>, type_pack<Ts..., T>>::value
+    && (FALCON_FOLD_OPTIMIZE_SIZE || sizeof...(Ts) + 3 >= FALCON_FOLD_ERASURE_THRESHOLD),
+    homogeneous_result<Fn, T>
+  >::type::type;
+
+  template<class T>
+  using always_true = std::true_type;
+
+  struct no_result
+  {};
+
+  template<class Fn, class Pack, class = void>
+  struct erased_result
+  {};
+
+  /// \c R = \c std::decay_t<f(x, y)> when all the arguments convert to \c R and \a Fn is closed on \c R
+  template<class Fn, class T, class U, class... Ts>
+  struct erased_result<Fn, type_pack<T, U, Ts...>, typename make_void<call_result_t<Fn, T, U>>::type>
+  : std::conditional<
+    std::is_same<
+      type_pack<typename std::is_convertible<T, call_result_t<Fn, T, U>>::type,
+                typename std::is_convertible<U, call_result_t<Fn, T, U>>::type,
+                typename std::is_convertible<Ts, call_result_t<Fn, T, U>>::type...>,
+      type_pack<always_true<T>, always_true<U>, always_true<Ts>...>
+    >::value,
+    homogeneous_result<Fn, call_result_t<Fn, T, U>>,
+    no_result
+  >::type
+  {};
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  using erased_fold_t = typename std::enable_if<
+    sizeof...(Ts) + 3 >= FALCON_FOLD_ERASURE_THRESHOLD,
+    erased_result<Fn, type_pack<T, U, V, Ts...>>
+  >::type::type;
+} }
+
 namespace fold {
 
 /**
@@ -219,35 +356,336 @@ foldt(Fn && f, T && x, U && y, Ts && ... args);
 /** @} */
 
 
+/**
+ * \brief  Runtime folds for the homogeneous packs and the huge packs
+ *
+ * When \a f is closed on \c R, the arguments are folded by a runtime loop
+ * with the pairing order of the shape. The loop is instantiated once per
+ * \a Fn, \c R and shape, instead of once per arity. Returns a \c R.
+ *
+ * - With \c FALCON_FOLD_OPTIMIZE_SIZE or from \c FALCON_FOLD_ERASURE_THRESHOLD
+ *   arguments, the arguments of same type and value category
+ *   (\c R is \c std::decay_t<T>) are read through an array of pointers.
+ * - From \c FALCON_FOLD_ERASURE_THRESHOLD arguments, the other packs are
+ *   read through an array of erased leaves when all the arguments convert
+ *   to \c R (\c std::decay_t<f(x, y)>). \a f receives the converted
+ *   leaves and these overloads are not \c constexpr: the result can
+ *   differ from the same fold with one argument less than the threshold.
+ * @{
+ */
+template<class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldr(Fn && f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldr(Fn && f, T && x, U && y, V && z, Ts && ... args);
+
+template<class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldl(Fn && f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldl(Fn && f, T && x, U && y, V && z, Ts && ... args);
+
+#if FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS
+template<class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldl(Fn & f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldl(Fn & f, T && x, U && y, V && z, Ts && ... args);
+#endif
+
+template<class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldbl(Fn && f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldbl(Fn && f, T && x, U && y, V && z, Ts && ... args);
+
+template<class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldbr(Fn && f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldbr(Fn && f, T && x, U && y, V && z, Ts && ... args);
+
+template<class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldt(Fn && f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldt(Fn && f, T && x, U && y, V && z, Ts && ... args);
+/** @} */
+
+
 /**
  * \brief  Apply \a f as a nested sub-expressions of 1 item, then 2, 4, 8, etc.
  *
+ * The groups have \a First elements, then \a First * \a Factor,
+ * \a First * \a Factor^2, etc. (the last one can be smaller).
+ * \a folder is called on each group, except on the first element when
+ * \a First is 1 (with 2 arguments, the result is \c f(x, y)).
+ *
  * \code foldp(foldt, f, 1, 2, 3, 4, 5, 6, 7, 8) \endcode
  * equivalent to
  * \code f(0, f(folder(1, 2), f(folder(3, 4, 5, 6), folder(7, 8)))) \endcode
+ *
+ * \code foldp<4, 2>(foldt, f, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11) \endcode
+ * equivalent to
+ * \code f(folder(1, 2), f(folder(3, 4, 5, 6, 7, 8, 9, 10), 11)) \endcode
  * @{
  */
-template<class Folder, class Fn>
+template<std::size_t Factor = 2, std::size_t First = 1, class Folder, class Fn>
 constexpr decltype(auto)
 foldp(Folder &&, Fn && f) {
   return std::forward<Fn>(f)();
 }
 
-template<class Folder, class Fn, class T>
+template<std::size_t Factor = 2, std::size_t First = 1, class Folder, class Fn, class T>
 constexpr decltype(auto)
 foldp(Folder &&, Fn &&, T && x) {
   return std::forward<T>(x);
 }
 
-template<class Folder, class Fn, class T, class U>
+template<std::size_t Factor = 2, std::size_t First = 1, class Folder, class Fn, class T, class U, class... Ts>
 constexpr decltype(auto)
-foldp(Folder &&, Fn && f, T && x, U && y) {
-  return std::forward<Fn>(f)(std::forward<T>(x), std::forward<U>(y));
+foldp(Folder && folder, Fn && f, T && x, U && y, Ts && ... args);
+/** @} */
+
+
+/**
+ * \brief  Shapes for the generic interfaces (\c transform_fold, ...)
+ *
+ * They are also split policies of \c foldtree: \c value(n) is the number
+ * of elements of the left sub-tree of a tree of \c n >= 2 elements.
+ * @{
+ */
+struct foldl_tag
+{
+  static constexpr std::size_t value(std::size_t n) { return n - 1; }
+};
+
+struct foldr_tag
+{
+  static constexpr std::size_t value(std::size_t) { return 1; }
+};
+
+struct foldbl_tag
+{
+  static constexpr std::size_t value(std::size_t n) { return n - n / 2; }
+};
+
+struct foldbr_tag
+{
+  static constexpr std::size_t value(std::size_t n) { return n / 2; }
+};
+
+struct foldt_tag
+{
+  static constexpr std::size_t value(std::size_t n)
+  { return n == 2 ? 1 : detail::fold::count_foldt_element(n); }
+};
+/** @} */
+
+
+/**
+ * \brief  Apply \a f as a tree where \c Policy::value(n) elements of \c n
+ * are in the left sub-tree
+ *
+ * \c Policy::value is a \c constexpr static function that returns a value
+ * in [1, n-1]. \c foldbl, \c foldbr and \c foldt are \c foldtree with
+ * \c foldbl_tag, \c foldbr_tag and \c foldt_tag.
+ *
+ * \code
+ * struct split8 {
+ *   static constexpr std::size_t value(std::size_t n)
+ *   { return n > 8 ? (n - 1) / 8 * 8 : n / 2; }
+ * };
+ * foldtree<split8>(f, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
+ * \endcode
+ * equivalent to
+ * \code f(f(f(f(1, 2), f(3, 4)), f(f(5, 6), f(7, 8))), f(9, 10)) \endcode
+ * @{
+ */
+template<class Policy, class Fn>
+constexpr decltype(auto)
+foldtree(Fn && f) {
+  return std::forward<Fn>(f)();
+}
+
+template<class Policy, class Fn, class T>
+constexpr decltype(auto)
+foldtree(Fn &&, T && x) {
+  return std::forward<T>(x);
+}
+
+template<class Policy, class Fn, class T, class U, class... Ts>
+constexpr decltype(auto)
+foldtree(Fn && f, T && x, U && y, Ts && ... args);
+
+template<class Policy, class Fn, class T, class... Ts>
+constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+foldtree(Fn && f, T && x, T && y, T && z, Ts && ... args);
+
+template<class Policy, class Fn, class T, class U, class V, class... Ts>
+detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+foldtree(Fn && f, T && x, U && y, V && z, Ts && ... args);
+/** @} */
+
+
+/**
+ * \brief  Apply \a f with the shape \a Tag on \c g(args)...
+ *
+ * \a g is called at the leaf level, when \a f needs the value.
+ *
+ * \code transform_fold<foldt_tag>(g, f, 1, 2, 3, 4, 5) \endcode
+ * equivalent to
+ * \code f(f(f(g(1), g(2)), f(g(3), g(4))), g(5)) \endcode
+ * @{
+ */
+template<class Tag, class G, class Fn>
+constexpr decltype(auto)
+transform_fold(G &&, Fn && f) {
+  return std::forward<Fn>(f)();
+}
+
+template<class Tag, class G, class Fn, class T>
+constexpr decltype(auto)
+transform_fold(G && g, Fn &&, T && x) {
+  return std::forward<G>(g)(std::forward<T>(x));
+}
+
+template<class Tag, class G, class Fn, class T, class U, class... Ts>
+constexpr decltype(auto)
+transform_fold(G && g, Fn && f, T && x, U && y, Ts && ... args);
+/** @} */
+
+/**
+ * \brief  Shortcuts for \c transform_fold<shape_tag>
+ * @{
+ */
+template<class G, class Fn, class... Ts>
+constexpr decltype(auto)
+transform_foldr(G && g, Fn && f, Ts && ... args) {
+  return transform_fold<foldr_tag>(
+    std::forward<G>(g), std::forward<Fn>(f), std::forward<Ts>(args)...);
+}
+
+template<class G, class Fn, class... Ts>
+constexpr decltype(auto)
+transform_foldl(G && g, Fn && f, Ts && ... args) {
+  return transform_fold<foldl_tag>(
+    std::forward<G>(g), std::forward<Fn>(f), std::forward<Ts>(args)...);
+}
+
+template<class G, class Fn, class... Ts>
+constexpr decltype(auto)
+transform_foldbl(G && g, Fn && f, Ts && ... args) {
+  return transform_fold<foldbl_tag>(
+    std::forward<G>(g), std::forward<Fn>(f), std::forward<Ts>(args)...);
+}
+
+template<class G, class Fn, class... Ts>
+constexpr decltype(auto)
+transform_foldbr(G && g, Fn && f, Ts && ... args) {
+  return transform_fold<foldbr_tag>(
+    std::forward<G>(g), std::forward<Fn>(f), std::forward<Ts>(args)...);
 }
 
-template<class Folder, class Fn, class T, class U, class V, class... Ts>
+template<class G, class Fn, class... Ts>
 constexpr decltype(auto)
-foldp(Folder && folder, Fn && f, T && x, U && y, V && z, Ts && ... args);
+transform_foldt(G && g, Fn && f, Ts && ... args) {
+  return transform_fold<foldt_tag>(
+    std::forward<G>(g), std::forward<Fn>(f), std::forward<Ts>(args)...);
+}
+/** @} */
+
+
+/**
+ * \brief  Apply each function of the tuple \a fns with the shape \a Tag in one pass
+ *
+ * Each argument is read once and given to all functions.
+ * Results are decayed.
+ *
+ * \code multi_fold(std::make_tuple(f1, f2), 1, 2, 3) \endcode
+ * equivalent to
+ * \code std::make_tuple(foldl(f1, 1, 2, 3), foldl(f2, 1, 2, 3)) \endcode
+ * @{
+ */
+template<class Tag = foldl_tag, class Fns>
+constexpr auto
+multi_fold(Fns && fns);
+
+template<class Tag = foldl_tag, class Fns, class T>
+constexpr auto
+multi_fold(Fns && fns, T && x);
+
+template<class Tag = foldl_tag, class Fns, class T, class U, class... Ts>
+constexpr auto
+multi_fold(Fns && fns, T && x, U && y, Ts && ... args);
+/** @} */
+
+
+/**
+ * \brief  Apply \a f with the shape \a Tag on each record of a structure of arrays
+ *
+ * Records are independent: the fold is done lane-wise and the loop can be
+ * vectorized (vertical reduction across records).
+ *
+ * \code batch_fold<foldt_tag>(f, n, out, a, b, c) \endcode
+ * equivalent to
+ * \code for (i = 0; i < n; ++i) out[i] = foldt(f, a[i], b[i], c[i]); \endcode
+ * \return  \c out + \a n
+ */
+template<class Tag, class Fn, class Size, class OutIt, class... Its>
+constexpr OutIt
+batch_fold(Fn && f, Size n, OutIt out, Its... fields);
+
+
+/**
+ * \brief  Partial results of \c foldl
+ *
+ * \code scanl(f, 1, 2, 3) \endcode
+ * equivalent to
+ * \code std::make_tuple(1, f(1, 2), f(f(1, 2), 3)) \endcode
+ * @{
+ */
+template<class Fn>
+constexpr std::tuple<>
+scanl(Fn &&) {
+  return {};
+}
+
+template<class Fn, class T, class... Ts>
+constexpr auto
+scanl(Fn && f, T && x, Ts && ... args);
+/** @} */
+
+
+/**
+ * \brief  Partial results of \c foldr
+ *
+ * \code scanr(f, 1, 2, 3) \endcode
+ * equivalent to
+ * \code std::make_tuple(f(1, f(2, 3)), f(2, 3), 3) \endcode
+ * @{
+ */
+template<class Fn>
+constexpr std::tuple<>
+scanr(Fn &&) {
+  return {};
+}
+
+template<class Fn, class T, class... Ts>
+constexpr auto
+scanr(Fn && f, T && x, Ts && ... args);
 /** @} */
 
 } // namespace fold
@@ -255,53 +693,109 @@ foldp(Folder && folder, Fn && f, T && x, U && y, V && z, Ts && ... args);
 
 // Implementation
 
-namespace detail { namespace { namespace fold {
+namespace detail { namespace fold {
   using std::size_t;
 
+#if FALCON_FOLD_USE_BRIGAND
+  template<class... Ts>
+  using list = brigand::list<Ts...>;
+
   template<size_t n, class... Ts>
 #if defined(__GNUC__) and !defined(__clang__) and __GNUC__ <= 5
-  using make_elems_t = brigand::pop_back<brigand::list<Ts...>, brigand::size_t<(brigand::size<brigand::list<Ts...>>::value - n)>>;
+  using make_elems_t = brigand::pop_back<list<Ts...>, brigand::size_t<(brigand::size<list<Ts...>>::value - n)>>;
+#else
+  using make_elems_t = brigand::pop_back<list<Ts...>, brigand::size_t<(sizeof...(Ts) - n)>>;
+#endif
 #else
-  using make_elems_t = brigand::pop_back<brigand::list<Ts...>, brigand::size_t<(sizeof...(Ts) - n)>>;
+  template<class... Ts>
+  struct list {};
+
+  template<size_t i, class T>
+  struct indexed_type
+  { using type = T; };
+
+  template<class Ints, class... Ts>
+  struct indexed_types;
+
+  template<size_t... Ints, class... Ts>
+  struct indexed_types<std::index_sequence<Ints...>, Ts...>
+  : indexed_type<Ints, Ts>...
+  {};
+
+  template<size_t i, class T>
+  indexed_type<i, T> get_indexed(indexed_type<i, T> const &);
+
+  template<class Ints>
+  struct take_elems;
+
+  template<size_t... Ints>
+  struct take_elems<std::index_sequence<Ints...>>
+  {
+    template<class... Ts>
+    using f = list<typename decltype(get_indexed<Ints>(
+      std::declval<indexed_types<std::index_sequence_for<Ts...>, Ts...>>()
+    ))::type...>;
+  };
+
+  /// first \a n elements of \a Ts
+  template<size_t n, class... Ts>
+  using make_elems_t = typename take_elems<std::make_index_sequence<n>>
+    ::template f<Ts...>;
 #endif
-} } }
+} }
 
 
 #if FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS
-namespace detail { namespace { namespace fold {
+namespace detail { namespace fold {
   template<class F, class T = void>
+  struct FoldFn;
+
+  template<class F, class T>
+  constexpr FoldFn<F&, T> foldfn(F & f, T && x)
+  { return {f, std::forward<T>(x)}; }
+
+  template<class F>
+  constexpr FoldFn<F&> foldfn(F & f)
+  { return {f}; }
+
+  // operators are hidden friends: found by ADL from an importer of the module
+  template<class F, class T>
   struct FoldFn
   {
     F fn;
     T value;
+
+    template<class U>
+    friend constexpr decltype(auto)
+    operator, (U && x, FoldFn && w) {
+      return foldfn(w.fn, w.fn(std::forward<U>(x), std::forward<T>(w.value)));
+    }
+
+    template<class U>
+    friend constexpr decltype(auto)
+    operator, (FoldFn && w, U && y) {
+      return foldfn(w.fn, w.fn(std::forward<T>(w.value), std::forward<U>(y)));
+    }
   };
 
   template<class F>
   struct FoldFn<F, void>
   {
     F fn;
-  };
 
-  template<class F, class T>
-  constexpr FoldFn<F&, T> foldfn(F & f, T && x)
-  { return {f, std::forward<T>(x)}; }
-
-  template<class F>
-  constexpr FoldFn<F&> foldfn(F & f)
-  { return {f}; }
-
-  template<class F, class T, class U>
-  constexpr decltype(auto)
-  operator, (T && x, FoldFn<F, U> && w) {
-    return foldfn(w.fn, w.fn(std::forward<T>(x), std::forward<U>(w.value)));
-  }
+    template<class U>
+    friend constexpr decltype(auto)
+    operator, (U && x, FoldFn && w) {
+      return FoldFn<F, U&&>{w.fn, std::forward<U>(x)};
+    }
 
-  template<class F, class T>
-  constexpr decltype(auto)
-  operator, (T && x, FoldFn<F> && w) {
-    return FoldFn<F, T&&>{w.fn, std::forward<T>(x)};
-  }
-} } }
+    template<class U>
+    friend constexpr decltype(auto)
+    operator, (FoldFn && w, U && y) {
+      return FoldFn<F, U&&>{w.fn, std::forward<U>(y)};
+    }
+  };
+} }
 
 namespace fold {
   template<class Fn, class T, class U, class... Ts>
@@ -319,24 +813,12 @@ namespace fold {
 }
 
 
-namespace detail { namespace { namespace fold {
-  template<class F, class T, class U>
-  constexpr decltype(auto)
-  operator, (FoldFn<F, T> && w, U && y) {
-    return foldfn(w.fn, w.fn(std::forward<T>(w.value), std::forward<U>(y)));
-  }
-
-  template<class F, class U>
-  constexpr decltype(auto)
-  operator, (FoldFn<F> && w, U && y) {
-    return FoldFn<F, U&&>{w.fn, std::forward<U>(y)};
-  }
-
+namespace detail { namespace fold {
   template<class Elems>
   struct foldl_impl;
 
   template<class... Ts>
-  struct foldl_impl<brigand::list<Ts...>>
+  struct foldl_impl<list<Ts...>>
   {
     template<class Fn, class U>
     static constexpr decltype(auto)
@@ -347,7 +829,7 @@ namespace detail { namespace { namespace fold {
       );
     }
   };
-} } }
+} }
 
 namespace fold {
   template<class Fn, class T, class U, class... Ts>
@@ -379,12 +861,12 @@ namespace fold {
   }
 }
 #else
-namespace detail { namespace { namespace fold {
+namespace detail { namespace fold {
   template<class Elems>
   struct foldr_impl;
 
   template<class T>
-  struct foldr_impl<brigand::list<T>>
+  struct foldr_impl<list<T>>
   {
     template<class Fn, class U>
     static constexpr decltype(auto)
@@ -403,7 +885,7 @@ namespace detail { namespace { namespace fold {
   };
 
   template<class... Ts>
-  struct foldr_impl<brigand::list<Ts...>>
+  struct foldr_impl<list<Ts...>>
   {
     template<class Fn, class... Us>
     static constexpr decltype(auto)
@@ -425,7 +907,7 @@ namespace detail { namespace { namespace fold {
       );
     }
   };
-} } }
+} }
 
 namespace fold {
   template<class Fn, class T, class U, class... Ts>
@@ -444,12 +926,22 @@ namespace fold {
 } // namespace fold
 
 
-namespace detail { namespace { namespace fold {
+namespace detail { namespace fold {
   template<class Elems>
   struct foldl_impl;
 
+  template<>
+  struct foldl_impl<list<>>
+  {
+    template<class Fn, class U1, class U2>
+    static constexpr decltype(auto)
+    impl(Fn && f, U1 && a, U2 && b) {
+      return std::forward<Fn>(f)(std::forward<U1>(a), std::forward<U2>(b));
+    }
+  };
+
   template<class T>
-  struct foldl_impl<brigand::list<T>>
+  struct foldl_impl<list<T>>
   {
     template<class Fn, class U1>
     static constexpr decltype(auto)
@@ -480,7 +972,7 @@ namespace detail { namespace { namespace fold {
   };
 
   template<class... Ts>
-  struct foldl_impl<brigand::list<Ts...>>
+  struct foldl_impl<list<Ts...>>
   {
     template<class Fn, class T, class... Us>
     static constexpr decltype(auto)
@@ -506,7 +998,7 @@ namespace detail { namespace { namespace fold {
       );
     }
   };
-} } }
+} }
 
 namespace fold {
   template<class Fn, class T, class U, class... Ts>
@@ -515,7 +1007,7 @@ namespace fold {
     return detail::fold::foldl_impl<
       detail::fold::make_elems_t<
         sizeof...(Ts)/2+1,
-        T&&, U&&, Ts&&...
+        U&&, Ts&&...
       >
     >::impl(
       std::forward<Fn>(f),
@@ -528,24 +1020,33 @@ namespace fold {
 #endif
 
 
-namespace detail { namespace { namespace fold {
-  template<class Elems>
-  struct foldbr_impl;
-
-  template<>
-  struct foldbr_impl<brigand::list<>>
+namespace detail { namespace fold {
+  /// size of the left sub-tree of \a n elements
+  template<class Policy, size_t n>
+  struct foldtree_split
   {
-    template<class Fn, class T>
-    static constexpr T &&
-    impl(Fn &&, T && e) {
-      return std::forward<T>(e);
-    }
+    static constexpr size_t value = Policy::value(n);
+    static_assert(0 < value && value < n, "Policy::value(n) must be in [1, n-1]");
   };
 
-  template<class T>
-  struct foldbr_impl<brigand::list<T>>
-#if FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS
+  template<class Policy>
+  struct foldtree_split<Policy, 1>
   {
+    static constexpr size_t value = 1;
+  };
+
+  template<class Policy, class Elems>
+  struct foldtree_impl;
+
+  template<class Policy, class T>
+  struct foldtree_impl<Policy, list<T>>
+  {
+    template<class Fn>
+    static constexpr T
+    impl(Fn &&, T a) {
+      return static_cast<T>(a);
+    }
+
     template<class Fn, class U>
     static constexpr decltype(auto)
     impl(Fn && f, T a, U && b) {
@@ -560,44 +1061,72 @@ namespace detail { namespace { namespace fold {
         f(std::forward<U1>(b), std::forward<U2>(c))
       );
     }
+
+    template<class Fn, class... Us>
+    static constexpr decltype(auto)
+    impl(Fn && f, T a, Us && ... args) {
+      return std::forward<Fn>(f)(
+        static_cast<T>(a),
+        foldtree_impl<
+          Policy,
+          make_elems_t<
+            foldtree_split<Policy, sizeof...(Us)>::value,
+            Us&&...
+          >
+        >::impl(f, std::forward<Us>(args)...)
+      );
+    }
   };
-#else
-  : foldr_impl<brigand::list<T>>
-  {};
-#endif
 
-  template<class... Ts>
-  struct foldbr_impl<brigand::list<Ts...>>
+  template<class Policy, class... Ts>
+  struct foldtree_impl<Policy, list<Ts...>>
   {
+    template<class Fn, class U>
+    static constexpr decltype(auto)
+    impl(Fn && f, Ts... e, U && b) {
+      return std::forward<Fn>(f)(
+        foldtree_impl<
+          Policy,
+          make_elems_t<
+            foldtree_split<Policy, sizeof...(Ts)>::value,
+            Ts...
+          >
+        >::impl(f, static_cast<Ts>(e)...),
+        std::forward<U>(b)
+      );
+    }
+
     template<class Fn, class... Us>
     static constexpr decltype(auto)
     impl(Fn && f, Ts... e, Us && ... args) {
       return std::forward<Fn>(f)(
-        foldbr_impl<
+        foldtree_impl<
+          Policy,
           make_elems_t<
-            sizeof...(Ts)/2,
+            foldtree_split<Policy, sizeof...(Ts)>::value,
             Ts...
           >
         >::impl(f, static_cast<Ts>(e)...),
-        foldbr_impl<
+        foldtree_impl<
+          Policy,
           make_elems_t<
-            sizeof...(Us)/2,
+            foldtree_split<Policy, sizeof...(Us)>::value,
             Us&&...
           >
         >::impl(f, std::forward<Us>(args)...)
       );
     }
   };
-} } }
+} }
 
 namespace fold {
-  template<class Fn, class T, class U, class... Ts>
+  template<class Policy, class Fn, class T, class U, class... Ts>
   constexpr decltype(auto)
-  foldbr(Fn && f, T && x, U && y, Ts && ... args) {
-    return
-    detail::fold::foldbr_impl<
+  foldtree(Fn && f, T && x, U && y, Ts && ... args) {
+    return detail::fold::foldtree_impl<
+      Policy,
       detail::fold::make_elems_t<
-        (2u+sizeof...(Ts))/2,
+        detail::fold::foldtree_split<Policy, sizeof...(Ts)+2>::value,
         T&&, U&&, Ts&&...
       >
     >::impl(
@@ -607,72 +1136,346 @@ namespace fold {
       std::forward<Ts>(args)...
     );
   }
+
+  template<class Fn, class T, class U, class... Ts>
+  constexpr decltype(auto)
+  foldbr(Fn && f, T && x, U && y, Ts && ... args) {
+    return foldtree<foldbr_tag>(
+      std::forward<Fn>(f),
+      std::forward<T>(x),
+      std::forward<U>(y),
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<class Fn, class T, class U, class... Ts>
+  constexpr decltype(auto)
+  foldbl(Fn && f, T && x, U && y, Ts && ... args) {
+    return foldtree<foldbl_tag>(
+      std::forward<Fn>(f),
+      std::forward<T>(x),
+      std::forward<U>(y),
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<class Fn, class T, class U, class... Ts>
+  constexpr decltype(auto)
+  foldt(Fn && f, T && x, U && y, Ts && ... args) {
+    return foldtree<foldt_tag>(
+      std::forward<Fn>(f),
+      std::forward<T>(x),
+      std::forward<U>(y),
+      std::forward<Ts>(args)...
+    );
+  }
 } // namespace fold
 
 
-namespace detail { namespace { namespace fold {
-  template<class Elems>
-  struct foldbl_impl;
+namespace detail { namespace fold {
+  template<class T, class P>
+  constexpr T&&
+  homogeneous_leaf(P * const * p, size_t i) {
+    return static_cast<T&&>(*p[i]);
+  }
 
-  template<class T>
-  struct foldbl_impl<brigand::list<T>>
+  template<class R, class T>
+  R erased_get(void const * p) {
+    return static_cast<T&&>(*static_cast<std::remove_reference_t<T>*>(const_cast<void*>(p)));
+  }
+
+  /// Arguments of any type converted to \a R by get[i](p[i])
+  template<class R>
+  struct erased_leaves
   {
-    template<class Fn>
-    static constexpr T
-    impl(Fn &&, T a) {
-      return static_cast<T>(a);
+    void const * const * p;
+    R (* const * get)(void const *);
+
+    constexpr erased_leaves operator+(size_t i) const {
+      return {p + i, get + i};
     }
+  };
 
-    template<class Fn, class U>
+  template<class T, class R>
+  R homogeneous_leaf(erased_leaves<R> const & leaves, size_t i) {
+    return leaves.get[i](leaves.p[i]);
+  }
+
+  // p is a sequence of n >= 2 leaves, homogeneous_leaf<T>(p, i) is an argument of f
+
+  template<class Tag>
+  struct homogeneous_fold
+  {
+    template<class R, class T, class Fn, class P>
+    static constexpr R
+    impl(Fn && f, P p, size_t n) {
+      size_t const left = Tag::value(n);
+      size_t const right = n - left;
+      if (left == 1) {
+        if (right == 1) {
+          return std::forward<Fn>(f)(homogeneous_leaf<T>(p, 0), homogeneous_leaf<T>(p, 1));
+        }
+        return std::forward<Fn>(f)(homogeneous_leaf<T>(p, 0), impl<R, T>(f, p + 1, right));
+      }
+      if (right == 1) {
+        return std::forward<Fn>(f)(impl<R, T>(f, p, left), homogeneous_leaf<T>(p, left));
+      }
+      return std::forward<Fn>(f)(impl<R, T>(f, p, left), impl<R, T>(f, p + left, right));
+    }
+  };
+
+  template<>
+  struct homogeneous_fold<::falcon::fold::foldl_tag>
+  {
+    template<class R, class T, class Fn, class P>
+    static constexpr R
+    impl(Fn && f, P p, size_t n) {
+      R acc = f(homogeneous_leaf<T>(p, 0), homogeneous_leaf<T>(p, 1));
+      for (size_t i = 2; i < n - 1; ++i) {
+        acc = f(std::move(acc), homogeneous_leaf<T>(p, i));
+      }
+      return std::forward<Fn>(f)(std::move(acc), homogeneous_leaf<T>(p, n - 1));
+    }
+  };
+
+  template<>
+  struct homogeneous_fold<::falcon::fold::foldr_tag>
+  {
+    template<class R, class T, class Fn, class P>
+    static constexpr R
+    impl(Fn && f, P p, size_t n) {
+      R acc = f(homogeneous_leaf<T>(p, n - 2), homogeneous_leaf<T>(p, n - 1));
+      for (size_t i = n - 2; --i > 0;) {
+        acc = f(homogeneous_leaf<T>(p, i), std::move(acc));
+      }
+      return std::forward<Fn>(f)(homogeneous_leaf<T>(p, 0), std::move(acc));
+    }
+  };
+
+  /// \c homogeneous_fold<Tag> on \a args read through erased leaves
+  template<class Tag, class R, class Fn, class... Ts>
+  R erased_fold(Fn && f, Ts && ... args) {
+    void const * const p[]{&args...};
+    static constexpr R (* const get[])(void const *){&erased_get<R, Ts>...};
+    return homogeneous_fold<Tag>::template impl<R, R>(
+      std::forward<Fn>(f), erased_leaves<R>{p, get}, sizeof...(Ts)
+    );
+  }
+} }
+
+namespace fold {
+  template<class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldr(Fn && f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<foldr_tag>::impl<std::decay_t<T>, T>(
+      std::forward<Fn>(f), p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldr(Fn && f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<foldr_tag, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      std::forward<Fn>(f), std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldl(Fn && f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<foldl_tag>::impl<std::decay_t<T>, T>(
+      std::forward<Fn>(f), p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldl(Fn && f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<foldl_tag, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      std::forward<Fn>(f), std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+
+#if FALCON_CXX_HAS_FEATURE_FOLD_EXPRESSIONS
+  template<class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldl(Fn & f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<foldl_tag>::impl<std::decay_t<T>, T>(
+      f, p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldl(Fn & f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<foldl_tag, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      f, std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+#endif
+
+  template<class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldbl(Fn && f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<foldbl_tag>::impl<std::decay_t<T>, T>(
+      std::forward<Fn>(f), p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldbl(Fn && f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<foldbl_tag, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      std::forward<Fn>(f), std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldbr(Fn && f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<foldbr_tag>::impl<std::decay_t<T>, T>(
+      std::forward<Fn>(f), p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldbr(Fn && f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<foldbr_tag, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      std::forward<Fn>(f), std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldt(Fn && f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<foldt_tag>::impl<std::decay_t<T>, T>(
+      std::forward<Fn>(f), p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldt(Fn && f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<foldt_tag, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      std::forward<Fn>(f), std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<class Policy, class Fn, class T, class... Ts>
+  constexpr detail::fold::homogeneous_fold_t<Fn, T, Ts...>
+  foldtree(Fn && f, T && x, T && y, T && z, Ts && ... args) {
+    std::remove_reference_t<T> * const p[]{&x, &y, &z, &args...};
+    return detail::fold::homogeneous_fold<Policy>::template impl<std::decay_t<T>, T>(
+      std::forward<Fn>(f), p, sizeof...(Ts) + 3
+    );
+  }
+
+  template<class Policy, class Fn, class T, class U, class V, class... Ts>
+  detail::fold::erased_fold_t<Fn, T, U, V, Ts...>
+  foldtree(Fn && f, T && x, U && y, V && z, Ts && ... args) {
+    return detail::fold::erased_fold<Policy, detail::fold::erased_fold_t<Fn, T, U, V, Ts...>>(
+      std::forward<Fn>(f), std::forward<T>(x), std::forward<U>(y), std::forward<V>(z),
+      std::forward<Ts>(args)...
+    );
+  }
+} // namespace fold
+
+
+namespace detail { namespace fold {
+  constexpr size_t
+  foldp_group_size(size_t size, size_t n) {
+    return size < n ? size : n;
+  }
+
+  // Elems is the next group, the following ones have Size * Factor elements
+  template<class Elems, size_t Size, size_t Factor>
+  struct foldp_impl;
+
+  template<class... Ts, size_t Size, size_t Factor>
+  struct foldp_impl<list<Ts...>, Size, Factor>
+  {
+    template<class Folder, class Fn>
     static constexpr decltype(auto)
-    impl(Fn && f, T a, U && b) {
-      return std::forward<Fn>(f)(static_cast<T>(a), std::forward<U>(b));
+    impl(Folder & folder, Fn &&, Ts... e) {
+      return folder(static_cast<Ts>(e)...);
     }
 
-    template<class Fn, class U1, class U2>
+    template<class Folder, class Fn, class... Us>
     static constexpr decltype(auto)
-    impl(Fn && f, T a, U1 && b, U2 && c) {
+    impl(Folder & folder, Fn && f, Ts... e, Us && ... args) {
       return std::forward<Fn>(f)(
-        f(static_cast<T>(a), std::forward<U1>(b)),
-        std::forward<U2>(c)
+        folder(static_cast<Ts>(e)...),
+        foldp_impl<
+          make_elems_t<
+            foldp_group_size(Size * Factor, sizeof...(args)),
+            Us && ...
+          >,
+          Size * Factor,
+          Factor
+        >::impl(folder, f, std::forward<Us>(args)...)
       );
     }
   };
 
-  template<class... Ts>
-  struct foldbl_impl<brigand::list<Ts...>>
+  template<size_t Factor, size_t First>
+  struct foldp_first
   {
-    template<class Fn, class... Us>
+    template<class Folder, class Fn, class... Ts>
     static constexpr decltype(auto)
-    impl(Fn && f, Ts... e, Us && ... args) {
+    impl(Folder & folder, Fn && f, Ts && ... args) {
+      return foldp_impl<
+        make_elems_t<foldp_group_size(First, sizeof...(args)), Ts && ...>,
+        First,
+        Factor
+      >::impl(folder, std::forward<Fn>(f), std::forward<Ts>(args)...);
+    }
+  };
+
+  // the first element is not given to folder, nor the second one of 2
+  template<size_t Factor>
+  struct foldp_first<Factor, 1>
+  {
+    template<class Folder, class Fn, class T, class U>
+    static constexpr decltype(auto)
+    impl(Folder &, Fn && f, T && x, U && y) {
+      return std::forward<Fn>(f)(std::forward<T>(x), std::forward<U>(y));
+    }
+
+    template<class Folder, class Fn, class T, class U, class V, class... Ts>
+    static constexpr decltype(auto)
+    impl(Folder & folder, Fn && f, T && x, U && y, V && z, Ts && ... args) {
       return std::forward<Fn>(f)(
-        foldbl_impl<
-          make_elems_t<
-            sizeof...(Ts)/2 + sizeof...(Ts) % 2,
-            Ts...
-          >
-        >::impl(f, static_cast<Ts>(e)...),
-        foldbl_impl<
-          make_elems_t<
-            sizeof...(Us)/2 + sizeof...(Us) % 2,
-            Us&&...
-          >
-        >::impl(f, std::forward<Us>(args)...)
+        std::forward<T>(x),
+        foldp_impl<
+          make_elems_t<foldp_group_size(Factor, sizeof...(args) + 2), U&&, V&&, Ts&&...>,
+          Factor,
+          Factor
+        >::impl(folder, f, std::forward<U>(y), std::forward<V>(z), std::forward<Ts>(args)...)
       );
     }
   };
-} } }
+} }
 
 namespace fold {
-  template<class Fn, class T, class U, class... Ts>
+  template<std::size_t Factor, std::size_t First, class Folder, class Fn, class T, class U, class... Ts>
   constexpr decltype(auto)
-  foldbl(Fn && f, T && x, U && y, Ts && ... args) {
-    return detail::fold::foldbl_impl<
-      detail::fold::make_elems_t<
-        sizeof...(Ts)/2 + sizeof...(Ts) % 2 + 1,
-        T&&, U&&, Ts&&...
-      >
-    >::impl(
+  foldp(Folder && folder, Fn && f, T && x, U && y, Ts && ... args) {
+    static_assert(Factor >= 1 && First >= 1, "Factor and First must be greater than 0");
+    return detail::fold::foldp_first<Factor, First>::impl(
+      folder,
       std::forward<Fn>(f),
       std::forward<T>(x),
       std::forward<U>(y),
@@ -682,164 +1485,367 @@ namespace fold {
 } // namespace fold
 
 
-namespace detail { namespace { namespace fold {
-#if defined(_MSC_VER) or defined(__clang__)
-  constexpr size_t
-  count_foldt_element2(size_t count, size_t pow = 1)
+namespace detail { namespace fold {
+  /// \c foldtree for the user-defined split policies
+  template<class Tag>
+  struct tag_fold
   {
-    return pow == 32
-      ? count
-      : count_foldt_element2(count | (count >> pow), pow * 2);
-  }
+    template<class Fn, class... Ts>
+    static constexpr decltype(auto)
+    impl(Fn && f, Ts && ... args) {
+      return ::falcon::fold::foldtree<Tag>(std::forward<Fn>(f), std::forward<Ts>(args)...);
+    }
+  };
 
-  constexpr size_t
-  count_foldt_element(size_t count)
-  {
-    return (count <= 2)
-      ? count
-      : (count_foldt_element2(count - 1) + 1) / 2;
-  }
-#else
-  constexpr size_t
-  count_foldt_element(size_t count)
+  template<>
+  struct tag_fold<::falcon::fold::foldr_tag>
   {
-    return (count <= 2)
-      ? count
-      : (
-        count -= 1,
-        count |= (count >> 1),
-        count |= (count >> 2),
-        count |= (count >> 4),
-        count |= (count >> 8),
-        count |= (count >> 16),
-        count += 1,
-        count / 2
-      );
-  }
-#endif
+    template<class Fn, class... Ts>
+    static constexpr decltype(auto)
+    impl(Fn && f, Ts && ... args) {
+      return ::falcon::fold::foldr(std::forward<Fn>(f), std::forward<Ts>(args)...);
+    }
+  };
 
-  template<class Elems>
-  struct foldt_impl;
+  template<>
+  struct tag_fold<::falcon::fold::foldl_tag>
+  {
+    template<class Fn, class... Ts>
+    static constexpr decltype(auto)
+    impl(Fn && f, Ts && ... args) {
+      return ::falcon::fold::foldl(std::forward<Fn>(f), std::forward<Ts>(args)...);
+    }
+  };
 
-  template<class T>
-  struct foldt_impl<brigand::list<T>>
+  template<>
+  struct tag_fold<::falcon::fold::foldbl_tag>
   {
-    template<class Fn>
-    static constexpr T
-    impl(Fn &, T e) {
-      return static_cast<T>(e);
+    template<class Fn, class... Ts>
+    static constexpr decltype(auto)
+    impl(Fn && f, Ts && ... args) {
+      return ::falcon::fold::foldbl(std::forward<Fn>(f), std::forward<Ts>(args)...);
     }
   };
 
-  template<class... Ts>
-  struct foldt_impl<brigand::list<Ts...>>
+  template<>
+  struct tag_fold<::falcon::fold::foldbr_tag>
   {
-    template<class Fn>
+    template<class Fn, class... Ts>
     static constexpr decltype(auto)
-    impl(Fn && f, Ts... e) {
-      return std::forward<Fn>(f)(static_cast<Ts>(e)...);
+    impl(Fn && f, Ts && ... args) {
+      return ::falcon::fold::foldbr(std::forward<Fn>(f), std::forward<Ts>(args)...);
     }
+  };
 
-    template<class Fn, class... Us>
+  template<>
+  struct tag_fold<::falcon::fold::foldt_tag>
+  {
+    template<class Fn, class... Ts>
     static constexpr decltype(auto)
-    impl(Fn && f, Ts... e, Us && ... args) {
-      return std::forward<Fn>(f)(
-        foldt_impl<
-          make_elems_t<
-            count_foldt_element(sizeof...(Ts)),
-            Ts...
-          >
-        >::impl(f, static_cast<Ts>(e)...),
-        foldt_impl<
-          make_elems_t<
-            count_foldt_element(sizeof...(Us)),
-            Us&&...
-          >
-        >::impl(f, std::forward<Us>(args)...)
+    impl(Fn && f, Ts && ... args) {
+      return ::falcon::fold::foldt(std::forward<Fn>(f), std::forward<Ts>(args)...);
+    }
+  };
+
+
+  template<class T>
+  struct TransformLeaf
+  {
+    using type = T;
+    T value;
+  };
+
+  template<class T>
+  struct is_transform_leaf : std::false_type
+  {};
+
+  template<class T>
+  struct is_transform_leaf<TransformLeaf<T>> : std::true_type
+  {};
+
+  template<class G, class T>
+  constexpr decltype(auto)
+  transform_leaf(G & g, T && x, std::true_type) {
+    return g(static_cast<typename std::decay_t<T>::type>(x.value));
+  }
+
+  template<class G, class T>
+  constexpr T &&
+  transform_leaf(G &, T && x, std::false_type) {
+    return std::forward<T>(x);
+  }
+
+  template<class G, class Fn>
+  struct TransformFn
+  {
+    G & g;
+    Fn && fn;
+
+    template<class T, class U>
+    constexpr decltype(auto)
+    operator()(T && x, U && y) & {
+      return fn(
+        transform_leaf(g, std::forward<T>(x), is_transform_leaf<std::decay_t<T>>{}),
+        transform_leaf(g, std::forward<U>(y), is_transform_leaf<std::decay_t<U>>{})
+      );
+    }
+
+    template<class T, class U>
+    constexpr decltype(auto)
+    operator()(T && x, U && y) && {
+      return std::forward<Fn>(fn)(
+        transform_leaf(g, std::forward<T>(x), is_transform_leaf<std::decay_t<T>>{}),
+        transform_leaf(g, std::forward<U>(y), is_transform_leaf<std::decay_t<U>>{})
       );
     }
   };
-} } }
+} }
 
 namespace fold {
-  template<class Fn, class T, class U, class... Ts>
+  template<class Tag, class G, class Fn, class T, class U, class... Ts>
   constexpr decltype(auto)
-  foldt(Fn && f, T && x, U && y, Ts && ... args) {
-    return detail::fold::foldt_impl<
-      detail::fold::make_elems_t<
-        detail::fold::count_foldt_element(sizeof...(Ts)+2),
-        T&&, U&&, Ts&&...
-      >
-    >::impl(
-      std::forward<Fn>(f),
-      std::forward<T>(x),
-      std::forward<U>(y),
-      std::forward<Ts>(args)...
+  transform_fold(G && g, Fn && f, T && x, U && y, Ts && ... args) {
+    return detail::fold::tag_fold<Tag>::impl(
+      detail::fold::TransformFn<G, Fn>{g, std::forward<Fn>(f)},
+      detail::fold::TransformLeaf<T&&>{std::forward<T>(x)},
+      detail::fold::TransformLeaf<U&&>{std::forward<U>(y)},
+      detail::fold::TransformLeaf<Ts&&>{std::forward<Ts>(args)}...
     );
   }
 } // namespace fold
 
 
-namespace detail { namespace { namespace fold {
-  template<class Elems, size_t Pow>
-  struct foldp_impl;
+namespace detail { namespace fold {
+  template<class Fns>
+  using fns_sequence = std::make_index_sequence<
+    std::tuple_size<std::decay_t<Fns>>::value
+  >;
+
+  template<std::size_t I, class T>
+  constexpr auto &
+  multi_get(T && x, std::true_type) {
+    return x.value;
+  }
+
+  template<std::size_t I, class T>
+  constexpr decltype(auto)
+  multi_get(T && x, std::false_type) {
+    return std::get<I>(std::forward<T>(x));
+  }
 
-  template<class... Ts, size_t Pow>
-  struct foldp_impl<brigand::list<Ts...>, Pow>
+  template<class Fns>
+  struct MultiFn
   {
-    template<class Folder, class Fn>
-    static constexpr decltype(auto)
-    impl(Folder & folder, Fn &, Ts... e) {
-      return folder(static_cast<Ts>(e)...);
+    Fns & fns;
+
+    template<class T, class U>
+    constexpr auto
+    operator()(T && x, U && y) {
+      return impl(fns_sequence<Fns>{}, std::forward<T>(x), std::forward<U>(y));
     }
 
-    template<class Folder, class Fn, class... Us>
-    static constexpr decltype(auto)
-    impl(Folder & folder, Fn & f, Ts... e, Us && ... args) {
-      return f(
-        folder(static_cast<Ts>(e)...),
-        foldp_impl<
-          make_elems_t<
-            std::min(Pow * 2u, sizeof...(args)),
-            Us && ...
-          >,
-          Pow * 2
-        >::impl(
-          folder,
-          f,
-          std::forward<Us>(args)...
-        )
-      );
+  private:
+    template<std::size_t... Ints, class T, class U>
+    constexpr auto
+    impl(std::index_sequence<Ints...>, T && x, U && y) {
+      using tx = is_transform_leaf<std::decay_t<T>>;
+      using ty = is_transform_leaf<std::decay_t<U>>;
+      return std::tuple<std::decay_t<decltype(std::get<Ints>(fns)(
+        multi_get<Ints>(std::forward<T>(x), tx{}),
+        multi_get<Ints>(std::forward<U>(y), ty{})
+      ))>...>(std::get<Ints>(fns)(
+        multi_get<Ints>(std::forward<T>(x), tx{}),
+        multi_get<Ints>(std::forward<U>(y), ty{})
+      )...);
     }
   };
-} } }
+
+  template<class Fns, std::size_t... Ints>
+  constexpr auto
+  multi_fold_empty(Fns & fns, std::index_sequence<Ints...>) {
+    return std::tuple<std::decay_t<decltype(std::get<Ints>(fns)())>...>(
+      std::get<Ints>(fns)()...
+    );
+  }
+
+  template<std::size_t, class T>
+  using first_type = T;
+
+  template<class T, std::size_t... Ints>
+  constexpr auto
+  multi_fold_single(T & x, std::index_sequence<Ints...>) {
+    return std::tuple<first_type<Ints, std::decay_t<T>>...>(
+      (void(Ints), x)...
+    );
+  }
+} }
 
 namespace fold {
-  template<class Folder, class Fn, class T, class U, class V, class... Ts>
-  constexpr decltype(auto)
-  foldp(Folder && folder, Fn && f, T && x, U && y, V && z, Ts && ... args) {
-    return std::forward<Fn>(f)(
-      std::forward<T>(x),
-      detail::fold::foldp_impl<
-        brigand::list<U&&, V&&>,
-        2u
-      >::impl(
-        folder,
-        f,
-        std::forward<U>(y),
-        std::forward<V>(z),
-        std::forward<Ts>(args)...
-      )
+  template<class Tag, class Fns>
+  constexpr auto
+  multi_fold(Fns && fns) {
+    return detail::fold::multi_fold_empty(
+      fns, detail::fold::fns_sequence<Fns>{});
+  }
+
+  template<class Tag, class Fns, class T>
+  constexpr auto
+  multi_fold(Fns &&, T && x) {
+    return detail::fold::multi_fold_single(
+      x, detail::fold::fns_sequence<Fns>{});
+  }
+
+  template<class Tag, class Fns, class T, class U, class... Ts>
+  constexpr auto
+  multi_fold(Fns && fns, T && x, U && y, Ts && ... args) {
+    return detail::fold::tag_fold<Tag>::impl(
+      detail::fold::MultiFn<std::remove_reference_t<Fns>>{fns},
+      detail::fold::TransformLeaf<T&&>{std::forward<T>(x)},
+      detail::fold::TransformLeaf<U&&>{std::forward<U>(y)},
+      detail::fold::TransformLeaf<Ts&&>{std::forward<Ts>(args)}...
     );
   }
 } // namespace fold
 
+
+namespace fold {
+  template<class Tag, class Fn, class Size, class OutIt, class... Its>
+  constexpr OutIt
+  batch_fold(Fn && f, Size n, OutIt out, Its... fields) {
+    for (Size i = 0; i < n; ++i) {
+      out[i] = detail::fold::tag_fold<Tag>::impl(f, fields[i]...);
+    }
+    return out + n;
+  }
+} // namespace fold
+
+
+namespace detail { namespace fold {
+  template<class Fn, class T>
+  constexpr auto
+  scanl_impl(Fn &, T && x) {
+    return std::tuple<std::decay_t<T>>(std::forward<T>(x));
+  }
+
+  template<class Fn, class T, class U, class... Ts>
+  constexpr auto
+  scanl_impl(Fn & f, T && x, U && y, Ts && ... args) {
+    return std::tuple_cat(
+      std::tuple<std::decay_t<T>>(x),
+      scanl_impl(f, f(x, std::forward<U>(y)), std::forward<Ts>(args)...)
+    );
+  }
+
+  template<class Fn, class T>
+  constexpr auto
+  scanr_impl(Fn &, T && x) {
+    return std::tuple<std::decay_t<T>>(std::forward<T>(x));
+  }
+
+  template<class Fn, class T, class U, class... Ts>
+  constexpr auto
+  scanr_impl(Fn & f, T && x, U && y, Ts && ... args) {
+    auto r = scanr_impl(f, std::forward<U>(y), std::forward<Ts>(args)...);
+    return std::tuple_cat(
+      std::make_tuple(f(std::forward<T>(x), std::get<0>(r))),
+      std::move(r)
+    );
+  }
+} }
+
+namespace fold {
+  template<class Fn, class T, class... Ts>
+  constexpr auto
+  scanl(Fn && f, T && x, Ts && ... args) {
+    return detail::fold::scanl_impl(f, std::forward<T>(x), std::forward<Ts>(args)...);
+  }
+
+  template<class Fn, class T, class... Ts>
+  constexpr auto
+  scanr(Fn && f, T && x, Ts && ... args) {
+    return detail::fold::scanr_impl(f, std::forward<T>(x), std::forward<Ts>(args)...);
+  }
+} // namespace fold
+
+
+namespace fold {
+/**
+ * \brief  Result of a fold on constants, computed once by instantiation
+ *
+ * \a Fn and \a Ts are default constructible literal types (\c std::integral_constant, ...).
+ *
+ * \code fold_c<foldt_tag, Fn, T1, T2, T3> \endcode
+ * equivalent to
+ * \code foldt(Fn{}, T1{}, T2{}, T3{}) \endcode
+ * @{
+ */
+template<class Tag, class Fn, class... Ts>
+FALCON_FOLD_INLINE_VARIABLE constexpr auto fold_c
+  = detail::fold::tag_fold<Tag>::impl(Fn{}, Ts{}...);
+
+template<class Fn, class... Ts>
+FALCON_FOLD_INLINE_VARIABLE constexpr auto const & foldr_c
+  = fold_c<foldr_tag, Fn, Ts...>;
+
+template<class Fn, class... Ts>
+FALCON_FOLD_INLINE_VARIABLE constexpr auto const & foldl_c
+  = fold_c<foldl_tag, Fn, Ts...>;
+
+template<class Fn, class... Ts>
+FALCON_FOLD_INLINE_VARIABLE constexpr auto const & foldbl_c
+  = fold_c<foldbl_tag, Fn, Ts...>;
+
+template<class Fn, class... Ts>
+FALCON_FOLD_INLINE_VARIABLE constexpr auto const & foldbr_c
+  = fold_c<foldbr_tag, Fn, Ts...>;
+
+template<class Fn, class... Ts>
+FALCON_FOLD_INLINE_VARIABLE constexpr auto const & foldt_c
+  = fold_c<foldt_tag, Fn, Ts...>;
+/** @} */
+
+#if defined(__cpp_nontype_template_parameter_auto) \
+  && __cpp_nontype_template_parameter_auto >= 201606
+/**
+ * \brief  Same as \c fold_c with values
+ *
+ * \code fold_v<foldt_tag, Fn, 1, 2, 3> \endcode
+ * equivalent to
+ * \code fold_c<foldt_tag, Fn, std::integral_constant<int, 1>, ...> \endcode
+ */
+template<class Tag, class Fn, auto... values>
+inline constexpr auto const & fold_v
+  = fold_c<Tag, Fn, std::integral_constant<decltype(values), values>...>;
+#endif
+} // namespace fold
+
 using fold::foldt;
+using fold::foldtree;
 using fold::foldp;
 using fold::foldbr;
 using fold::foldbl;
 using fold::foldr;
 using fold::foldl;
+using fold::transform_fold;
+using fold::transform_foldt;
+using fold::transform_foldbr;
+using fold::transform_foldbl;
+using fold::transform_foldr;
+using fold::transform_foldl;
+using fold::multi_fold;
+using fold::batch_fold;
+using fold::scanl;
+using fold::scanr;
+using fold::fold_c;
+using fold::foldr_c;
+using fold::foldl_c;
+using fold::foldbl_c;
+using fold::foldbr_c;
+using fold::foldt_c;
+#if defined(__cpp_nontype_template_parameter_auto) \
+  && __cpp_nontype_template_parameter_auto >= 201606
+using fold::fold_v;
+#endif
 
 } // namespace falcon
 
@@ -0,0 +1,473 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Fold functions on asynchronous values: async_fold, async_foldt, async_foldbl and fold_as_ready.
+ *
+ * An asynchronous operation (`op`) is an object with a `value_type` member
+ * type and callable with a callback: `op(cb)` starts the operation and
+ * calls `cb(value)` once, from any thread.
+ *
+ * With C++20 coroutines, awaitables (`await_ready`/`await_suspend`/`await_resume`
+ * or a member `operator co_await`) are also accepted and the result of
+ * the folds can be `co_await`ed.
+ */
+
+#ifndef FALCON_FOLD_ASYNC_HPP
+#define FALCON_FOLD_ASYNC_HPP
+
+#include <falcon/fold.hpp>
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <initializer_list>
+
+#if defined(__cpp_impl_coroutine) and defined(__has_include)
+# if __has_include(<coroutine>)
+#  include <coroutine>
+#  include <exception> // std::terminate
+#  define FALCON_FOLD_ASYNC_COROUTINE 1
+# endif
+#endif
+
+#ifndef FALCON_FOLD_ASYNC_COROUTINE
+# define FALCON_FOLD_ASYNC_COROUTINE 0
+#endif
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Asynchronous operation that combines the results of \a ops with
+ * the shape \a Tag. \a f is called as soon as the two sub-trees are completed,
+ * on the thread of the last completion.
+ *
+ * \code async_fold<foldt_tag>(f, op1, op2, op3)(cb) \endcode
+ * calls
+ * \code cb(foldt(f, value1, value2, value3)) \endcode
+ */
+template<class Tag, class Fn, class... Ops>
+auto
+async_fold(Fn && f, Ops && ... ops);
+
+/**
+ * \brief  Shortcuts for \c async_fold<shape_tag>
+ * @{
+ */
+template<class Fn, class... Ops>
+auto
+async_foldt(Fn && f, Ops && ... ops) {
+  return async_fold<foldt_tag>(std::forward<Fn>(f), std::forward<Ops>(ops)...);
+}
+
+template<class Fn, class... Ops>
+auto
+async_foldbl(Fn && f, Ops && ... ops) {
+  return async_fold<foldbl_tag>(std::forward<Fn>(f), std::forward<Ops>(ops)...);
+}
+/** @} */
+
+/**
+ * \brief  Asynchronous operation already completed
+ */
+template<class T>
+struct async_ready
+{
+  using value_type = T;
+
+  T value;
+
+  template<class Cb>
+  void operator()(Cb && cb) {
+    std::forward<Cb>(cb)(std::move(value));
+  }
+};
+
+/**
+ * \brief  Asynchronous operation that combines the results of \a ops in
+ * completion order: as soon as two values are available, they are combined
+ * (dynamic tree instead of a static shape).
+ *
+ * \a f must be associative and commutative and the values of \a ops have
+ * the same type.
+ *
+ * \code fold_as_ready(f, op1, op2, op3)(cb) \endcode
+ * if op3, op1 then op2 are completed, calls
+ * \code cb(f(f(value3, value1), value2)) \endcode
+ * @{
+ */
+template<class Fn>
+auto
+fold_as_ready(Fn && f) {
+  using value_type = std::decay_t<decltype(f())>;
+  return async_ready<value_type>{f()};
+}
+
+template<class Fn, class Op, class... Ops>
+auto
+fold_as_ready(Fn && f, Op && op, Ops && ... ops);
+/** @} */
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  template<class T>
+  class AsyncSlot
+  {
+  public:
+    AsyncSlot() = default;
+    AsyncSlot(AsyncSlot const &) = delete;
+    AsyncSlot & operator=(AsyncSlot const &) = delete;
+
+    ~AsyncSlot() {
+      if (has_value_) {
+        get().~T();
+      }
+    }
+
+    template<class U>
+    void set(U && x) {
+      new (&data_) T(std::forward<U>(x));
+      has_value_ = true;
+    }
+
+    T & get() {
+      return *reinterpret_cast<T*>(&data_);
+    }
+
+    bool has_value() const noexcept {
+      return has_value_;
+    }
+
+    T take() {
+      T x = std::move(get());
+      get().~T();
+      has_value_ = false;
+      return x;
+    }
+
+  private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data_;
+    bool has_value_ = false;
+  };
+
+  template<class Fn, class L, class R, class Cb>
+  struct AsyncJoin
+  {
+    std::shared_ptr<Fn> fn;
+    Cb cb;
+    std::atomic<int> count {2};
+    AsyncSlot<L> left;
+    AsyncSlot<R> right;
+
+    AsyncJoin(std::shared_ptr<Fn> f, Cb c)
+    : fn(std::move(f))
+    , cb(std::move(c))
+    {}
+
+    void done() {
+      if (--count == 0) {
+        cb((*fn)(std::move(left.get()), std::move(right.get())));
+      }
+    }
+  };
+
+  template<class Op>
+  using async_value_t = typename std::decay_t<Op>::value_type;
+
+#if FALCON_FOLD_ASYNC_COROUTINE
+  template<class Op>
+  struct AsyncAwaiter
+  {
+    using value_type = async_value_t<Op>;
+
+    Op op;
+    AsyncSlot<value_type> result;
+    std::coroutine_handle<> handle;
+    std::atomic<bool> ready {false};
+
+    explicit AsyncAwaiter(Op && o)
+    : op(std::move(o))
+    {}
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+      handle = h;
+      op([this](auto && x) {
+        result.set(static_cast<decltype(x)&&>(x));
+        // the last of await_suspend and the callback resumes the coroutine
+        if (ready.exchange(true)) {
+          handle.resume();
+        }
+      });
+      return !ready.exchange(true);
+    }
+
+    value_type await_resume() {
+      return std::move(result.get());
+    }
+  };
+#endif
+
+  template<class Fn, class A, class B>
+  struct AsyncNode
+  {
+    using value_type = std::decay_t<decltype(std::declval<Fn&>()(
+      std::declval<async_value_t<A>>(),
+      std::declval<async_value_t<B>>()
+    ))>;
+
+    std::shared_ptr<Fn> fn;
+    A a;
+    B b;
+
+    template<class Cb>
+    void operator()(Cb && cb) {
+      using join_type = AsyncJoin<
+        Fn, async_value_t<A>, async_value_t<B>, std::decay_t<Cb>
+      >;
+      auto join = std::make_shared<join_type>(fn, std::forward<Cb>(cb));
+      a([join](auto && x) {
+        join->left.set(static_cast<decltype(x)&&>(x));
+        join->done();
+      });
+      b([join](auto && x) {
+        join->right.set(static_cast<decltype(x)&&>(x));
+        join->done();
+      });
+    }
+
+#if FALCON_FOLD_ASYNC_COROUTINE
+    AsyncAwaiter<AsyncNode> operator co_await() && {
+      return AsyncAwaiter<AsyncNode>{std::move(*this)};
+    }
+#endif
+  };
+
+  template<class Fn>
+  struct AsyncCombine
+  {
+    std::shared_ptr<Fn> fn;
+
+    auto operator()() const {
+      using value_type = std::decay_t<decltype((*fn)())>;
+      return ::falcon::fold::async_ready<value_type>{(*fn)()};
+    }
+
+    template<class A, class B>
+    auto operator()(A && a, B && b) const {
+      return AsyncNode<Fn, std::decay_t<A>, std::decay_t<B>>{
+        fn, std::forward<A>(a), std::forward<B>(b)
+      };
+    }
+  };
+
+  template<class T, class Fn, class Cb>
+  struct AsReadyState
+  {
+    std::shared_ptr<Fn> fn;
+    Cb cb;
+    std::mutex mutex;
+    /// values received, being combined or not yet received
+    std::size_t remaining;
+    AsyncSlot<T> pending;
+
+    AsReadyState(std::shared_ptr<Fn> f, Cb c, std::size_t n)
+    : fn(std::move(f))
+    , cb(std::move(c))
+    , remaining(n)
+    {}
+
+    void push(T x) {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (remaining != 1) {
+        if (!pending.has_value()) {
+          pending.set(std::move(x));
+          return;
+        }
+        T y = pending.take();
+        --remaining;
+        lock.unlock();
+        x = (*fn)(std::move(y), std::move(x));
+        lock.lock();
+      }
+      lock.unlock();
+      cb(std::move(x));
+    }
+  };
+
+  template<class Fn, class T, class... Ops>
+  struct AsReadyOp
+  {
+    using value_type = T;
+
+    std::shared_ptr<Fn> fn;
+    std::tuple<Ops...> ops;
+
+    template<class Cb>
+    void operator()(Cb && cb) {
+      start(std::forward<Cb>(cb), std::index_sequence_for<Ops...>{});
+    }
+
+#if FALCON_FOLD_ASYNC_COROUTINE
+    auto operator co_await() &&;
+#endif
+
+  private:
+    template<class Cb, std::size_t... Ints>
+    void start(Cb && cb, std::index_sequence<Ints...>) {
+      using state_type = AsReadyState<T, Fn, std::decay_t<Cb>>;
+      auto state = std::make_shared<state_type>(
+        fn, std::forward<Cb>(cb), sizeof...(Ops)
+      );
+      (void)std::initializer_list<int>{(void(std::get<Ints>(ops)(
+        [state](auto && x) {
+          state->push(T(static_cast<decltype(x)&&>(x)));
+        }
+      )), 0)...};
+    }
+  };
+
+#if FALCON_FOLD_ASYNC_COROUTINE
+  template<class Fn, class T, class... Ops>
+  auto AsReadyOp<Fn, T, Ops...>::operator co_await() && {
+    return AsyncAwaiter<AsReadyOp>{std::move(*this)};
+  }
+
+  struct AsyncDetached
+  {
+    struct promise_type
+    {
+      AsyncDetached get_return_object() noexcept { return {}; }
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { std::terminate(); }
+    };
+  };
+
+  template<class Aw, class Cb>
+  AsyncDetached
+  async_await_then(Aw aw, Cb cb) {
+    cb(co_await std::move(aw));
+  }
+
+  template<class Aw, class = void>
+  struct awaiter_type
+  { using type = Aw; };
+
+  template<class Aw>
+  struct awaiter_type<Aw, decltype(void(std::declval<Aw>().operator co_await()))>
+  { using type = decltype(std::declval<Aw>().operator co_await()); };
+
+  template<class Aw>
+  struct AwaitableOp
+  {
+    using value_type = std::decay_t<decltype(
+      std::declval<typename awaiter_type<Aw>::type&>().await_resume()
+    )>;
+
+    Aw aw;
+
+    template<class Cb>
+    void operator()(Cb && cb) {
+      async_await_then(std::move(aw), std::decay_t<Cb>(std::forward<Cb>(cb)));
+    }
+
+    AsyncAwaiter<AwaitableOp> operator co_await() && {
+      return AsyncAwaiter<AwaitableOp>{std::move(*this)};
+    }
+  };
+
+  template<class T>
+  AwaitableOp<std::decay_t<T>>
+  as_async_op(T && x, char) {
+    return {std::forward<T>(x)};
+  }
+#endif
+
+  template<class T, class = async_value_t<T>>
+  std::decay_t<T>
+  as_async_op(T && x, int) {
+    return std::forward<T>(x);
+  }
+} }
+
+namespace fold {
+  template<class Tag, class Fn, class... Ops>
+  auto
+  async_fold(Fn && f, Ops && ... ops) {
+    using fn_type = std::decay_t<Fn>;
+    return detail::fold::tag_fold<Tag>::impl(
+      detail::fold::AsyncCombine<fn_type>{
+        std::make_shared<fn_type>(std::forward<Fn>(f))
+      },
+      detail::fold::as_async_op(std::forward<Ops>(ops), 1)...
+    );
+  }
+
+  template<class Fn, class Op, class... Ops>
+  auto
+  fold_as_ready(Fn && f, Op && op, Ops && ... ops) {
+    using fn_type = std::decay_t<Fn>;
+    using value_type = std::common_type_t<
+      detail::fold::async_value_t<decltype(
+        detail::fold::as_async_op(std::forward<Op>(op), 1))>,
+      detail::fold::async_value_t<decltype(
+        detail::fold::as_async_op(std::forward<Ops>(ops), 1))>...
+    >;
+    using op_type = detail::fold::AsReadyOp<
+      fn_type, value_type,
+      decltype(detail::fold::as_async_op(std::forward<Op>(op), 1)),
+      decltype(detail::fold::as_async_op(std::forward<Ops>(ops), 1))...
+    >;
+    return op_type{
+      std::make_shared<fn_type>(std::forward<Fn>(f)),
+      std::make_tuple(
+        detail::fold::as_async_op(std::forward<Op>(op), 1),
+        detail::fold::as_async_op(std::forward<Ops>(ops), 1)...
+      )
+    };
+  }
+} // namespace fold
+
+using fold::async_fold;
+using fold::async_foldt;
+using fold::async_foldbl;
+using fold::fold_as_ready;
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,327 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     foldt on the records of a file with a bounded memory and checkpoints: external_foldt.
+ *
+ * A serializer of `R` is an object with
+ * `save(std::ostream &, R const &)` and `R load(std::istream &)`.
+ */
+
+#ifndef FALCON_FOLD_EXTERNAL_HPP
+#define FALCON_FOLD_EXTERNAL_HPP
+
+#include <falcon/fold/stream.hpp>
+
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <sstream>
+#include <utility>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+
+#if FALCON_FOLD_FD
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Serializer of a trivially copyable type (bytes of the object)
+ */
+template<class R>
+struct trivial_serializer
+{
+  static_assert(std::is_trivially_copyable<R>::value, "R must be trivially copyable");
+
+  void save(std::ostream & out, R const & x) const {
+    out.write(reinterpret_cast<char const *>(&x), sizeof(R));
+  }
+
+  R load(std::istream & in) const {
+    R x;
+    in.read(reinterpret_cast<char *>(&x), sizeof(R));
+    return x;
+  }
+};
+
+/**
+ * \brief  \c range_foldt on the records of a file with at most
+ * 2 chunks of records and O(log n) partial results in memory
+ *
+ * The file is read as \c fold_stream with \c foldt_tag. After every
+ * \a checkpoint_interval chunks, the \c foldt_state is saved in
+ * \a checkpoint_path with \a serializer, with the size and the path of the
+ * file. The checkpoint is written in a temporary file synchronized on the
+ * disk (\c fdatasync), renamed, then the directory is synchronized.
+ * When \a checkpoint_path exists, the state is loaded and the reading
+ * starts after the records already folded: a fold interrupted by an
+ * exception or a crash is resumed without reading again the completed
+ * chunks. The checkpoint is removed at the end.
+ *
+ * \throw std::system_error when the file cannot be opened or the
+ * checkpoint cannot be written or removed
+ * \throw std::runtime_error when the checkpoint is invalid or was written
+ * with another \a chunk_size or for another file (path or size)
+ */
+template<class Record, class Fn, class Serializer>
+range_result_t<Fn, Record const *>
+external_foldt(
+  std::string const & path, std::size_t chunk_size, Fn && f,
+  Serializer const & serializer, std::string const & checkpoint_path,
+  std::size_t checkpoint_interval = 1);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  constexpr char const * checkpoint_magic = "falcon.fold.foldt_state.2";
+
+  /// identity of the folded file
+  struct CheckpointHeader
+  {
+    std::size_t chunk_size;
+    std::size_t file_size;
+    std::string file_path;
+  };
+
+#if FALCON_FOLD_FD
+  [[noreturn]] inline void
+  throw_checkpoint_error(int e, char const * what, std::string const & path)
+  {
+    throw std::system_error(e, std::generic_category(), "external_foldt: " + (what + (" " + path)));
+  }
+
+  inline void write_synced(std::string const & path, std::string const & data)
+  {
+    int const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd == -1) {
+      throw_checkpoint_error(errno, "cannot open", path);
+    }
+    char const * p = data.data();
+    std::size_t n = data.size();
+    while (n) {
+      ssize_t const r = ::write(fd, p, n);
+      if (r == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        int const e = errno;
+        ::close(fd);
+        throw_checkpoint_error(e, "cannot write", path);
+      }
+      p += r;
+      n -= static_cast<std::size_t>(r);
+    }
+# if defined(__APPLE__)
+    int const synced = ::fsync(fd);
+# else
+    int const synced = ::fdatasync(fd);
+# endif
+    int const e = errno;
+    if (::close(fd) == -1 || synced == -1) {
+      throw_checkpoint_error(synced == -1 ? e : errno, "cannot synchronize", path);
+    }
+  }
+
+  /// the renaming is durable once the directory is synchronized
+  inline void sync_parent_directory(std::string const & path)
+  {
+    std::string::size_type const pos = path.rfind('/');
+    std::string const dir
+      = pos == std::string::npos ? std::string(".")
+      : pos == 0 ? std::string("/")
+      : path.substr(0, pos);
+    int const fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw_checkpoint_error(errno, "cannot open", dir);
+    }
+    int const synced = ::fsync(fd);
+    int const e = errno;
+    ::close(fd);
+    if (synced == -1) {
+      throw_checkpoint_error(e, "cannot synchronize", dir);
+    }
+  }
+#endif
+
+  template<class R, class Serializer>
+  void save_checkpoint(
+    std::string const & path, CheckpointHeader const & header,
+    ::falcon::fold::foldt_state<R> const & state, Serializer const & serializer)
+  {
+    std::ostringstream out(std::ios::binary);
+    out << checkpoint_magic << '\n'
+      << header.chunk_size << ' ' << header.file_size << ' '
+      << state.subtrees().size() << '\n'
+      << header.file_path << '\n';
+    for (auto const & tree : state.subtrees()) {
+      out << tree.first << '\n';
+      serializer.save(out, tree.second);
+    }
+    if (!out) {
+      throw std::runtime_error("external_foldt: cannot serialize the state");
+    }
+
+    std::string const tmp = path + ".tmp";
+#if FALCON_FOLD_FD
+    write_synced(tmp, out.str());
+    if (std::rename(tmp.c_str(), path.c_str())) {
+      throw_checkpoint_error(errno, "cannot rename", tmp);
+    }
+    sync_parent_directory(path);
+#else
+    {
+      std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+      file << out.str();
+      file.flush();
+      if (!file) {
+        throw std::runtime_error("external_foldt: cannot write " + tmp);
+      }
+    }
+    if (std::rename(tmp.c_str(), path.c_str())) {
+      throw std::runtime_error("external_foldt: cannot rename " + tmp);
+    }
+#endif
+  }
+
+  /// empty state when \a path does not exist
+  template<class R, class Serializer>
+  ::falcon::fold::foldt_state<R> load_checkpoint(
+    std::string const & path, CheckpointHeader const & header,
+    Serializer const & serializer)
+  {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      return {};
+    }
+    std::string magic;
+    std::size_t saved_chunk_size = 0;
+    std::size_t saved_file_size = 0;
+    std::size_t n = 0;
+    std::string saved_file_path;
+    in >> magic >> saved_chunk_size >> saved_file_size >> n;
+    in.get(); // '\n'
+    std::getline(in, saved_file_path);
+    if (!in || magic != checkpoint_magic) {
+      throw std::runtime_error("external_foldt: invalid checkpoint " + path);
+    }
+    if (saved_chunk_size != header.chunk_size) {
+      throw std::runtime_error("external_foldt: checkpoint with another chunk size " + path);
+    }
+    if (saved_file_path != header.file_path || saved_file_size != header.file_size) {
+      throw std::runtime_error(
+        "external_foldt: checkpoint " + path + " of another file (" + saved_file_path + ")");
+    }
+    std::vector<std::pair<std::size_t, R>> trees;
+    trees.reserve(n);
+    while (n--) {
+      std::size_t size = 0;
+      in >> size;
+      in.get(); // '\n'
+      trees.emplace_back(size, serializer.load(in));
+    }
+    if (!in) {
+      throw std::runtime_error("external_foldt: truncated checkpoint " + path);
+    }
+    return ::falcon::fold::foldt_state<R>(std::move(trees));
+  }
+} }
+
+namespace fold {
+  template<class Record, class Fn, class Serializer>
+  range_result_t<Fn, Record const *>
+  external_foldt(
+    std::string const & path, std::size_t chunk_size, Fn && f,
+    Serializer const & serializer, std::string const & checkpoint_path,
+    std::size_t checkpoint_interval)
+  {
+    static_assert(std::is_trivially_copyable<Record>::value, "Record must be trivially copyable");
+    using R = range_result_t<Fn, Record const *>;
+    using Folder = detail::fold::StreamFolder<R, Fn, foldt_tag>;
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+      throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory),
+        "external_foldt: " + path);
+    }
+    std::streamoff const file_size = in.tellg();
+    if (file_size == -1) {
+      throw std::runtime_error("external_foldt: cannot get the size of " + path);
+    }
+
+    std::size_t const n = Folder::chunk_size(chunk_size ? chunk_size : 1);
+    detail::fold::CheckpointHeader const header{n, static_cast<std::size_t>(file_size), path};
+    Folder folder{f, detail::fold::load_checkpoint<R>(checkpoint_path, header, serializer)};
+
+    if (!in.seekg(static_cast<std::streamoff>(folder.state.size() * sizeof(Record)))) {
+      throw std::runtime_error("external_foldt: cannot seek in " + path);
+    }
+
+    std::size_t const interval = checkpoint_interval ? checkpoint_interval : 1;
+    std::size_t chunks = 0;
+    detail::fold::double_buffered_read(
+      detail::fold::IStreamRead{in}, n * sizeof(Record),
+      [&](char const * p, std::size_t size) {
+        if (size % sizeof(Record)) {
+          throw std::runtime_error("external_foldt: the file ends in the middle of a record");
+        }
+        auto const first = reinterpret_cast<Record const *>(p);
+        folder(first, first + size / sizeof(Record));
+        if (++chunks % interval == 0) {
+          detail::fold::save_checkpoint(checkpoint_path, header, folder.state, serializer);
+        }
+      }
+    );
+
+    R r = folder.result();
+    if (std::remove(checkpoint_path.c_str())) {
+      int const e = errno;
+      // without checkpoint when the file has less than checkpoint_interval chunks
+      if (e != ENOENT) {
+        throw std::system_error(e, std::generic_category(),
+          "external_foldt: cannot remove " + checkpoint_path);
+      }
+    }
+    return r;
+  }
+} // namespace fold
+
+using fold::trivial_serializer;
+using fold::external_foldt;
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,335 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Fold functions on the records of a file: mapped_file and fold_file.
+ *
+ * The file is mapped read-only (POSIX `mmap`) and the records are read in
+ * place, without copy. Without `mmap`, the file is read in memory (buffer
+ * aligned on `std::max_align_t`).
+ */
+
+#ifndef FALCON_FOLD_FILE_HPP
+#define FALCON_FOLD_FILE_HPP
+
+#include <falcon/fold/range.hpp>
+#include <falcon/fold/stream.hpp> // StreamFolder
+#include <falcon/fold/parallel.hpp>
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+#ifndef FALCON_FOLD_MMAP
+# if defined(__unix__) or defined(__APPLE__)
+#  define FALCON_FOLD_MMAP 1
+# else
+#  define FALCON_FOLD_MMAP 0
+# endif
+#endif
+
+#if FALCON_FOLD_MMAP
+# include <cerrno>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Content of a file mapped read-only
+ *
+ * The mapping is advised as sequential (\c MADV_SEQUENTIAL, \c MADV_WILLNEED)
+ * and, when available, backed by huge pages (\c MADV_HUGEPAGE). These are
+ * hints that the system may ignore.
+ *
+ * \throw std::system_error when the file cannot be opened or mapped
+ */
+class mapped_file
+{
+public:
+  explicit mapped_file(std::string const & path);
+  ~mapped_file();
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file & operator=(mapped_file const &) = delete;
+
+  char const * data() const noexcept {
+    return data_;
+  }
+
+  std::size_t size() const noexcept {
+    return size_;
+  }
+
+private:
+  char const * data_ = nullptr;
+  std::size_t size_ = 0;
+#if !FALCON_FOLD_MMAP
+  std::unique_ptr<std::max_align_t[]> buffer_;
+#endif
+};
+
+/**
+ * \brief  Apply \a f with the shape of \a Tag on the records of a file
+ *
+ * The file is a sequence of \a Record (trivially copyable) without header,
+ * read through a \c mapped_file.
+ * \a Tag is \c foldl_tag, \c foldt_tag, \c foldbl_tag or \c foldbr_tag:
+ * the result is the same as \c range_foldl, \c range_foldt, \c range_foldbl or
+ * \c range_foldbr on the records.
+ *
+ * With \c foldl_tag and \c foldt_tag, the records are folded by chunks of
+ * about 4 MiB (a power of 2 of records and a multiple of the page size) as
+ * \c fold_stream, and the pages of a folded chunk are released
+ * (\c MADV_DONTNEED): the resident memory stays bounded on a large file.
+ * \c foldbl_tag and \c foldbr_tag split the whole range and fold it in
+ * one call.
+ *
+ * \code fold_file<std::uint32_t>("data.bin", std::plus<>{}, foldt_tag{}) \endcode
+ *
+ * \throw std::system_error when the file cannot be mapped
+ * \throw std::runtime_error when the size of the file is not a multiple of \c sizeof(Record)
+ */
+template<class Record, class Tag = foldl_tag, class Fn>
+range_result_t<Fn, Record const *>
+fold_file(std::string const & path, Fn && f, Tag = Tag{});
+
+/**
+ * \brief  \c par_range_foldt<Grain> on the records of a file
+ *
+ * Same result as \c fold_file<Record>(path, f, foldt_tag{}).
+ * \a executor is a \c thread_pool (or another executor) or a \c numa_pool
+ * (\c falcon/fold/numa.hpp).
+ */
+template<class Record, std::size_t Grain = 16384, class Executor, class Fn>
+range_result_t<Fn, Record const *>
+par_fold_file(Executor & executor, std::string const & path, Fn && f);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  template<class Record>
+  std::pair<Record const *, Record const *>
+  file_records(::falcon::fold::mapped_file const & file)
+  {
+    static_assert(std::is_trivially_copyable<Record>::value, "Record must be trivially copyable");
+    static_assert(alignof(Record) <= alignof(std::max_align_t), "Record is over-aligned");
+    if (file.size() % sizeof(Record)) {
+      throw std::runtime_error("fold_file: the size is not a multiple of the record size");
+    }
+    // the mapping is aligned on a page, the buffer of the fallback on std::max_align_t
+    auto const first = reinterpret_cast<Record const *>(file.data());
+    return {first, first + file.size() / sizeof(Record)};
+  }
+
+  template<class Fn, class It>
+  decltype(auto) range_fold(::falcon::fold::foldl_tag, Fn & f, It first, It last)
+  { return ::falcon::fold::range_foldl(f, first, last); }
+
+  template<class Fn, class It>
+  decltype(auto) range_fold(::falcon::fold::foldt_tag, Fn & f, It first, It last)
+  { return ::falcon::fold::range_foldt(f, first, last); }
+
+  template<class Fn, class It>
+  decltype(auto) range_fold(::falcon::fold::foldbl_tag, Fn & f, It first, It last)
+  { return ::falcon::fold::range_foldbl(f, first, last); }
+
+  template<class Fn, class It>
+  decltype(auto) range_fold(::falcon::fold::foldbr_tag, Fn & f, It first, It last)
+  { return ::falcon::fold::range_foldbr(f, first, last); }
+
+  /// size of the chunks of fold_file
+  constexpr std::size_t file_chunk_bytes = std::size_t{1} << 22;
+
+  inline std::size_t page_size() noexcept
+  {
+#if FALCON_FOLD_MMAP
+    long const n = ::sysconf(_SC_PAGESIZE);
+    return n > 0 ? static_cast<std::size_t>(n) : 4096;
+#else
+    return 4096;
+#endif
+  }
+
+  /// the pages of [p, p+n) are read again from the file when needed
+  inline void release_pages(void const * p, std::size_t n) noexcept
+  {
+#if FALCON_FOLD_MMAP && defined(MADV_DONTNEED)
+    (void)::madvise(const_cast<void *>(p), n, MADV_DONTNEED);
+#else
+    (void)p;
+    (void)n;
+#endif
+  }
+
+  /// chunks of a power of 2 of records: a chunk starts on a page
+  template<class Tag, class Fn, class Record>
+  ::falcon::fold::range_result_t<Fn, Record const *>
+  fold_file_chunks(Fn & f, Record const * first, Record const * last)
+  {
+    using R = ::falcon::fold::range_result_t<Fn, Record const *>;
+    StreamFolder<R, Fn, Tag> folder{f, {}};
+    std::size_t const page = page_size();
+    std::size_t n = 1;
+    while (n < file_chunk_bytes / sizeof(Record) || n < page) {
+      n *= 2;
+    }
+    while (first != last) {
+      std::size_t const remaining = static_cast<std::size_t>(last - first);
+      std::size_t const m = remaining < n ? remaining : n;
+      folder(first, first + m);
+      release_pages(first, m * sizeof(Record));
+      first += m;
+    }
+    return folder.result();
+  }
+
+  template<class Fn, class Record>
+  decltype(auto) fold_file_records(::falcon::fold::foldl_tag, Fn & f, Record const * first, Record const * last)
+  { return fold_file_chunks<::falcon::fold::foldl_tag>(f, first, last); }
+
+  template<class Fn, class Record>
+  decltype(auto) fold_file_records(::falcon::fold::foldt_tag, Fn & f, Record const * first, Record const * last)
+  { return fold_file_chunks<::falcon::fold::foldt_tag>(f, first, last); }
+
+  /// foldbl and foldbr: the whole range
+  template<class Tag, class Fn, class Record>
+  decltype(auto) fold_file_records(Tag tag, Fn & f, Record const * first, Record const * last)
+  { return range_fold(tag, f, first, last); }
+
+#if FALCON_FOLD_MMAP
+  /// \a e: errno
+  [[noreturn]] inline void
+  throw_file_error(int e, char const * what, std::string const & path)
+  {
+    throw std::system_error(e, std::generic_category(), what + (": " + path));
+  }
+#endif
+} }
+
+namespace fold {
+#if FALCON_FOLD_MMAP
+  inline mapped_file::mapped_file(std::string const & path)
+  {
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      detail::fold::throw_file_error(errno, "open", path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+      int const e = errno;
+      ::close(fd);
+      detail::fold::throw_file_error(e, "fstat", path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_) {
+      void * p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        int const e = errno;
+        ::close(fd);
+        detail::fold::throw_file_error(e, "mmap", path);
+      }
+      data_ = static_cast<char const *>(p);
+      (void)::madvise(p, size_, MADV_SEQUENTIAL);
+      (void)::madvise(p, size_, MADV_WILLNEED);
+# ifdef MADV_HUGEPAGE
+      (void)::madvise(p, size_, MADV_HUGEPAGE);
+# endif
+    }
+    // the mapping remains valid
+    ::close(fd);
+  }
+
+  inline mapped_file::~mapped_file()
+  {
+    if (size_) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+  }
+#else
+  inline mapped_file::mapped_file(std::string const & path)
+  {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+      throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory), "open: " + path);
+    }
+    std::streamoff const size = file.tellg();
+    if (size == -1) {
+      throw std::system_error(
+        std::make_error_code(std::errc::io_error), "tellg: " + path);
+    }
+    size_ = static_cast<std::size_t>(size);
+    buffer_.reset(new std::max_align_t[(size_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+    char * const data = reinterpret_cast<char *>(buffer_.get());
+    file.seekg(0);
+    file.read(data, static_cast<std::streamsize>(size_));
+    if (static_cast<std::size_t>(file.gcount()) != size_) {
+      throw std::system_error(
+        std::make_error_code(std::errc::io_error), "read: " + path);
+    }
+    data_ = data;
+  }
+
+  inline mapped_file::~mapped_file() = default;
+#endif
+
+  template<class Record, class Tag, class Fn>
+  range_result_t<Fn, Record const *>
+  fold_file(std::string const & path, Fn && f, Tag tag) {
+    mapped_file const file(path);
+    auto const records = detail::fold::file_records<Record>(file);
+    return detail::fold::fold_file_records(tag, f, records.first, records.second);
+  }
+
+  template<class Record, std::size_t Grain, class Executor, class Fn>
+  range_result_t<Fn, Record const *>
+  par_fold_file(Executor & executor, std::string const & path, Fn && f) {
+    mapped_file const file(path);
+    auto const records = detail::fold::file_records<Record>(file);
+    return par_range_foldt<Grain>(executor, f, records.first, records.second);
+  }
+} // namespace fold
+
+using fold::mapped_file;
+using fold::fold_file;
+using fold::par_fold_file;
+
+} // namespace falcon
+
+#endif
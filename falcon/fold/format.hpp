@@ -0,0 +1,189 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Concatenation of strings in a buffer without allocation: fold_format.
+ */
+
+#ifndef FALCON_FOLD_FORMAT_HPP
+#define FALCON_FOLD_FORMAT_HPP
+
+#include <falcon/fold.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <functional> // std::plus
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Result of \c fold_format
+ */
+struct format_result
+{
+  /// end of the written characters
+  char * end;
+  /// length of the full string (without truncation)
+  std::size_t size;
+  /// \c size is greater than the size of the buffer
+  bool truncated;
+};
+
+/**
+ * \brief  Write \a pieces separated by \a sep in [buffer, buffer + size)
+ *
+ * A piece (and \a sep) is a \c char, a null-terminated string (a null pointer
+ * is an empty piece) or an object with \c data() and \c size()
+ * (\c std::string, \c std::string_view, ...).
+ * The total length is computed at runtime before the copy (\c foldl of
+ * the lengths, \c strlen for the null-terminated strings), then the pieces
+ * are written with \c foldl without allocation.
+ * When the buffer is too small, the string is truncated (like \c snprintf)
+ * and \c truncated is set. No null character is added.
+ *
+ * \code fold_format(buf, sizeof(buf), ", ", "a", std::string("bc"), 'd') \endcode
+ * writes
+ * \code "a, bc, d" \endcode
+ */
+template<class Sep, class... Ts>
+format_result
+fold_format(char * buffer, std::size_t size, Sep const & sep, Ts const & ... pieces);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  struct format_piece
+  {
+    char const * data;
+    std::size_t size;
+  };
+
+  inline format_piece
+  make_format_piece(char const & c) {
+    return {&c, 1};
+  }
+
+  inline format_piece
+  make_format_piece(char const * s) {
+    return {s, s ? std::strlen(s) : 0};
+  }
+
+  /// \a p.data may be null when \a p.size is 0
+  inline char *
+  copy_format_piece(char * out, format_piece const & p) {
+    if (p.size) {
+      std::memcpy(out, p.data, p.size);
+    }
+    return out + p.size;
+  }
+
+  template<class S>
+  auto
+  make_format_piece(S const & s)
+  -> decltype(format_piece{s.data(), std::size_t(s.size())}) {
+    return {s.data(), std::size_t(s.size())};
+  }
+
+  // the length is known, without bounds checking
+  struct format_writer
+  {
+    format_piece sep;
+
+    char * operator()(char * out, format_piece const & p) const {
+      return copy_format_piece(copy_format_piece(out, sep), p);
+    }
+  };
+
+  struct format_sink
+  {
+    char * out;
+    std::size_t avail;
+
+    format_sink write(format_piece const & p) const {
+      std::size_t const n = p.size < avail ? p.size : avail;
+      if (n) {
+        std::memcpy(out, p.data, n);
+      }
+      return {out + n, avail - n};
+    }
+  };
+
+  struct format_truncated_writer
+  {
+    format_piece sep;
+
+    format_sink operator()(format_sink sink, format_piece const & p) const {
+      return sink.write(sep).write(p);
+    }
+  };
+
+  inline ::falcon::fold::format_result
+  fold_format(char * buffer, std::size_t, format_piece const &) {
+    return {buffer, 0, false};
+  }
+
+  template<class... Pieces>
+  ::falcon::fold::format_result
+  fold_format(
+    char * buffer, std::size_t size, format_piece const & sep,
+    format_piece const & x, Pieces const & ... pieces
+  ) {
+    std::size_t const total
+      = foldl(std::plus<>{}, x.size, pieces.size...)
+      + sep.size * sizeof...(pieces);
+    if (total <= size) {
+      return {
+        foldl(format_writer{sep}, copy_format_piece(buffer, x), pieces...),
+        total, false
+      };
+    }
+    return {
+      foldl(format_truncated_writer{sep}, format_sink{buffer, size}.write(x), pieces...).out,
+      total, true
+    };
+  }
+} }
+
+namespace fold {
+  template<class Sep, class... Ts>
+  format_result
+  fold_format(char * buffer, std::size_t size, Sep const & sep, Ts const & ... pieces) {
+    return detail::fold::fold_format(
+      buffer, size,
+      detail::fold::make_format_piece(sep),
+      detail::fold::make_format_piece(pieces)...);
+  }
+} // namespace fold
+
+using fold::fold_format;
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,132 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Hash of a parameter list: ops::hash_combine and hash_fold.
+ */
+
+#ifndef FALCON_FOLD_HASH_HPP
+#define FALCON_FOLD_HASH_HPP
+
+#include <falcon/fold.hpp>
+
+#include <cstdint>
+#include <functional> // std::hash
+
+
+namespace falcon {
+namespace fold {
+namespace ops {
+
+/**
+ * \brief  Combine two hashes (not commutative)
+ *
+ * \c f(x,y) is \c mix(x^rotl(mix(y),31)) where \c mix is a bijection
+ * (finalizer of MurmurHash3): both operands are mixed, differently, and
+ * the hash depends on the order of the leaves with any shape.
+ * With \c foldt, the sub-trees are independent: the critical path is
+ * \c log2(n) calls instead of \c n with \c foldl.
+ *
+ * Without argument, returns the seed (hash of an empty list).
+ */
+struct hash_combine
+{
+  constexpr std::uint64_t
+  operator()() const {
+    return 0;
+  }
+
+  constexpr std::uint64_t
+  operator()(std::uint64_t x, std::uint64_t y) const {
+    return mix(x ^ rotl(mix(y), 31));
+  }
+
+  /// Bijection with a good avalanche, used at the end of \c hash_fold
+  static constexpr std::uint64_t
+  mix(std::uint64_t x) {
+    x ^= 0x9e3779b97f4a7c15u;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdu;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53u;
+    x ^= x >> 33;
+    return x;
+  }
+
+private:
+  static constexpr std::uint64_t
+  rotl(std::uint64_t x, unsigned k) {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+} // namespace ops
+
+
+/**
+ * \brief  Hash of \a args: \c std::hash at the leaf level, combined with
+ * \c ops::hash_combine in the shape \a Tag then mixed.
+ *
+ * \code hash_fold(a, b, c) \endcode
+ * equivalent to
+ * \code
+ * ops::hash_combine::mix(transform_foldt(
+ *   [](auto const & x) { return std::hash<decltype(x)>{}(x); },
+ *   ops::hash_combine{}, a, b, c))
+ * \endcode
+ */
+template<class Tag = foldt_tag, class... Ts>
+std::uint64_t
+hash_fold(Ts const & ... args);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  struct std_hash
+  {
+    template<class T>
+    std::uint64_t operator()(T const & x) const {
+      return std::hash<T>{}(x);
+    }
+  };
+} }
+
+namespace fold {
+  template<class Tag, class... Ts>
+  std::uint64_t
+  hash_fold(Ts const & ... args) {
+    return ops::hash_combine::mix(transform_fold<Tag>(
+      detail::fold::std_hash{}, ops::hash_combine{}, args...));
+  }
+} // namespace fold
+
+using fold::hash_fold;
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,132 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Precompiled overloads of foldl, foldr and foldt for common signatures.
+ *
+ * Link with the \c falcon_fold_instantiations library. The overloads are in
+ * \c falcon::fold::precompiled, with the templates of \c falcon::fold: a call
+ * qualified with \c precompiled (or after \c using \c namespace) uses the
+ * non-template overload when the arguments match exactly, without
+ * instantiation in the caller. \c falcon::foldl and others are unchanged:
+ * - \c foldl, \c foldr and \c foldt with \c std::plus<> and 4 to 16 \c int, \c long or \c double,
+ * - \c foldl with \c std::plus<> and 4 to 16 lvalues of \c std::string (concatenation).
+ *
+ * They are not \c constexpr. Rvalue strings still use the templates (moves).
+ */
+
+#ifndef FALCON_FOLD_INSTANTIATIONS_HPP
+#define FALCON_FOLD_INSTANTIATIONS_HPP
+
+#include <falcon/fold.hpp>
+
+#include <string>
+#include <functional> // std::plus
+
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_1(T) T a1
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_2(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_1(T), T a2
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_3(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_2(T), T a3
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_4(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_3(T), T a4
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_5(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_4(T), T a5
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_6(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_5(T), T a6
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_7(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_6(T), T a7
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_8(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_7(T), T a8
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_9(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_8(T), T a9
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_10(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_9(T), T a10
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_11(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_10(T), T a11
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_12(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_11(T), T a12
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_13(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_12(T), T a13
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_14(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_13(T), T a14
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_15(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_14(T), T a15
+#define FALCON_FOLD_INSTANTIATIONS_PARAMS_16(T) FALCON_FOLD_INSTANTIATIONS_PARAMS_15(T), T a16
+
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_1 a1
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_2 FALCON_FOLD_INSTANTIATIONS_ARGS_1, a2
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_3 FALCON_FOLD_INSTANTIATIONS_ARGS_2, a3
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_4 FALCON_FOLD_INSTANTIATIONS_ARGS_3, a4
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_5 FALCON_FOLD_INSTANTIATIONS_ARGS_4, a5
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_6 FALCON_FOLD_INSTANTIATIONS_ARGS_5, a6
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_7 FALCON_FOLD_INSTANTIATIONS_ARGS_6, a7
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_8 FALCON_FOLD_INSTANTIATIONS_ARGS_7, a8
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_9 FALCON_FOLD_INSTANTIATIONS_ARGS_8, a9
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_10 FALCON_FOLD_INSTANTIATIONS_ARGS_9, a10
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_11 FALCON_FOLD_INSTANTIATIONS_ARGS_10, a11
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_12 FALCON_FOLD_INSTANTIATIONS_ARGS_11, a12
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_13 FALCON_FOLD_INSTANTIATIONS_ARGS_12, a13
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_14 FALCON_FOLD_INSTANTIATIONS_ARGS_13, a14
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_15 FALCON_FOLD_INSTANTIATIONS_ARGS_14, a15
+#define FALCON_FOLD_INSTANTIATIONS_ARGS_16 FALCON_FOLD_INSTANTIATIONS_ARGS_15, a16
+
+#define FALCON_FOLD_INSTANTIATIONS_ARITIES(M, name, R, P) \
+  M(name, R, P, 4) \
+  M(name, R, P, 5) \
+  M(name, R, P, 6) \
+  M(name, R, P, 7) \
+  M(name, R, P, 8) \
+  M(name, R, P, 9) \
+  M(name, R, P, 10) \
+  M(name, R, P, 11) \
+  M(name, R, P, 12) \
+  M(name, R, P, 13) \
+  M(name, R, P, 14) \
+  M(name, R, P, 15) \
+  M(name, R, P, 16)
+
+/// M(name, result_type, param_type, arity) for each precompiled overload
+#define FALCON_FOLD_INSTANTIATIONS(M)                                             \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldl, int, int)                          \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldr, int, int)                          \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldt, int, int)                          \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldl, long, long)                        \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldr, long, long)                        \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldt, long, long)                        \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldl, double, double)                    \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldr, double, double)                    \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldt, double, double)                    \
+  FALCON_FOLD_INSTANTIATIONS_ARITIES(M, foldl, std::string, std::string const &)
+
+
+namespace falcon {
+namespace fold {
+namespace precompiled {
+
+#define FALCON_FOLD_INSTANTIATIONS_DECLARE(name, R, P, n) \
+  R name(std::plus<>, FALCON_FOLD_INSTANTIATIONS_PARAMS_##n(P));
+
+FALCON_FOLD_INSTANTIATIONS(FALCON_FOLD_INSTANTIATIONS_DECLARE)
+
+#undef FALCON_FOLD_INSTANTIATIONS_DECLARE
+
+// other signatures
+using ::falcon::fold::foldt;
+using ::falcon::fold::foldr;
+using ::falcon::fold::foldl;
+
+} // namespace precompiled
+} // namespace fold
+} // namespace falcon
+
+#endif
@@ -0,0 +1,321 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Parallel range folds partitioned by NUMA node: numa_nodes, numa_pool and par_range_foldt.
+ *
+ * The topology is read in `/sys/devices/system/node` (Linux). Without it,
+ * there is a single node and the threads are not pinned.
+ */
+
+#ifndef FALCON_FOLD_NUMA_HPP
+#define FALCON_FOLD_NUMA_HPP
+
+#include <falcon/fold/parallel.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef FALCON_FOLD_NUMA_AFFINITY
+# if defined(__linux__)
+#  define FALCON_FOLD_NUMA_AFFINITY 1
+# else
+#  define FALCON_FOLD_NUMA_AFFINITY 0
+# endif
+#endif
+
+#if FALCON_FOLD_NUMA_AFFINITY
+# include <sched.h>
+#endif
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  NUMA node and its CPUs
+ */
+struct numa_node
+{
+  unsigned id;
+  /// empty when unknown: the threads of the node are not pinned
+  std::vector<unsigned> cpus;
+};
+
+/**
+ * \brief  Nodes with at least 1 CPU, or a single node without CPU when the
+ * topology is not available
+ */
+std::vector<numa_node> numa_nodes();
+
+/**
+ * \brief  One \c thread_pool per NUMA node with the threads pinned on the CPUs of the node
+ *
+ * A range is partitioned into \c size() contiguous parts of (almost) the
+ * same size, the part \c i is processed by the threads of the node \c i.
+ * Initializing the data with \c for_each_part places the pages of each part
+ * on its node (first-touch placement of Linux), then \c par_range_foldt
+ * reads them locally.
+ */
+class numa_pool
+{
+public:
+  /// \a threads_per_node: 0 for the number of CPUs of each node
+  explicit numa_pool(
+    std::vector<numa_node> nodes = numa_nodes(),
+    std::size_t threads_per_node = 0);
+
+  /// number of nodes
+  std::size_t size() const noexcept {
+    return nodes_.size();
+  }
+
+  numa_node const & node(std::size_t i) const {
+    return nodes_[i];
+  }
+
+  thread_pool & pool(std::size_t i) {
+    return *pools_[i];
+  }
+
+  /**
+   * \brief  Call \a fn(i, part_first, part_last) on a thread of the node \c i
+   * for each non-empty part of [first, last), then wait
+   *
+   * The first exception is rethrown. Must not be called from a thread of the pool.
+   */
+  template<class It, class Fn>
+  void for_each_part(It first, It last, Fn fn);
+
+private:
+  std::vector<numa_node> nodes_;
+  std::vector<std::unique_ptr<thread_pool>> pools_;
+};
+
+/**
+ * \brief  Fold of each part of [first, last) on its node with
+ * \c par_range_foldt<Grain>, then \c range_foldt of the partial results
+ * (1 per node)
+ *
+ * Same result as \c range_foldt when \a f is associative.
+ */
+template<std::size_t Grain = 16384, class Fn, class It>
+range_result_t<Fn, It>
+par_range_foldt(numa_pool & pool, Fn && f, It first, It last);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  /// "0-3,8,10-11"
+  inline std::vector<unsigned>
+  parse_cpulist(std::string const & s)
+  {
+    std::vector<unsigned> cpus;
+    std::size_t i = 0;
+    while (i < s.size()) {
+      std::size_t end = 0;
+      unsigned long const a = std::stoul(s.substr(i), &end);
+      unsigned long b = a;
+      i += end;
+      if (i < s.size() && s[i] == '-') {
+        ++i;
+        b = std::stoul(s.substr(i), &end);
+        i += end;
+      }
+      for (unsigned long cpu = a; cpu <= b; ++cpu) {
+        cpus.push_back(static_cast<unsigned>(cpu));
+      }
+      while (i < s.size() && (s[i] == ',' || s[i] == '\n')) {
+        ++i;
+      }
+    }
+    return cpus;
+  }
+
+  inline std::vector<unsigned>
+  read_cpulist(std::string const & path)
+  {
+    std::ifstream file(path);
+    std::string s;
+    if (!std::getline(file, s)) {
+      return {};
+    }
+    try {
+      return parse_cpulist(s);
+    }
+    catch (std::exception const &) {
+      return {};
+    }
+  }
+
+  inline void
+  numa_bind_thread(::falcon::fold::numa_node const & node)
+  {
+#if FALCON_FOLD_NUMA_AFFINITY
+    if (node.cpus.empty()) {
+      return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : node.cpus) {
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    // a hint: without permission, the thread runs anywhere
+    (void)sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)node;
+#endif
+  }
+
+  template<class It>
+  It numa_part(It first, std::size_t n, std::size_t i, std::size_t k)
+  {
+    return std::next(first, static_cast<std::ptrdiff_t>(n * i / k));
+  }
+} }
+
+namespace fold {
+  inline std::vector<numa_node>
+  numa_nodes()
+  {
+    std::vector<numa_node> nodes;
+    std::string const dir = "/sys/devices/system/node/";
+    for (unsigned id : detail::fold::read_cpulist(dir + "online")) {
+      auto cpus = detail::fold::read_cpulist(
+        dir + "node" + std::to_string(id) + "/cpulist");
+      if (!cpus.empty()) {
+        nodes.push_back({id, std::move(cpus)});
+      }
+    }
+    if (nodes.empty()) {
+      nodes.push_back({0, {}});
+    }
+    return nodes;
+  }
+
+  inline numa_pool::numa_pool(std::vector<numa_node> nodes, std::size_t threads_per_node)
+  : nodes_(std::move(nodes))
+  {
+    if (nodes_.empty()) {
+      nodes_.push_back({0, {}});
+    }
+    for (numa_node const & node : nodes_) {
+      std::size_t n = threads_per_node;
+      if (!n) {
+        n = node.cpus.empty()
+          ? std::thread::hardware_concurrency() / nodes_.size()
+          : node.cpus.size();
+      }
+      pools_.emplace_back(new thread_pool(n, [node](std::size_t) {
+        detail::fold::numa_bind_thread(node);
+      }));
+    }
+  }
+
+  template<class It, class Fn>
+  void numa_pool::for_each_part(It first, It last, Fn fn)
+  {
+    std::size_t const n = static_cast<std::size_t>(std::distance(first, last));
+    std::size_t const k = size();
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t remaining = 0;
+    std::exception_ptr error;
+
+    for (std::size_t i = 0; i < k; ++i) {
+      It const a = detail::fold::numa_part(first, n, i, k);
+      It const b = detail::fold::numa_part(first, n, i + 1, k);
+      if (a == b) {
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++remaining;
+      }
+      pools_[i]->post([&, i, a, b]{
+        std::exception_ptr e;
+        try {
+          fn(i, a, b);
+        }
+        catch (...) {
+          e = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (e && !error) {
+          error = e;
+        }
+        if (--remaining == 0) {
+          cv.notify_one();
+        }
+      });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]{ return remaining == 0; });
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  template<std::size_t Grain, class Fn, class It>
+  range_result_t<Fn, It>
+  par_range_foldt(numa_pool & pool, Fn && f, It first, It last)
+  {
+    using R = range_result_t<Fn, It>;
+    if (first == last) {
+      return detail::fold::range_empty<R>(f, 1);
+    }
+    std::unique_ptr<detail::fold::AsyncSlot<R>[]> partials(
+      new detail::fold::AsyncSlot<R>[pool.size()]);
+    pool.for_each_part(first, last, [&](std::size_t i, It a, It b) {
+      partials[i].set(par_range_foldt<Grain>(pool.pool(i), f, a, b));
+    });
+    std::vector<R> results;
+    results.reserve(pool.size());
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+      if (partials[i].has_value()) {
+        results.push_back(partials[i].take());
+      }
+    }
+    return range_foldt(f, results.begin(), results.end());
+  }
+} // namespace fold
+
+using fold::numa_node;
+using fold::numa_nodes;
+using fold::numa_pool;
+using fold::par_range_foldt;
+
+} // namespace falcon
+
+#endif
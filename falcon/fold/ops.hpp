@@ -0,0 +1,211 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Binary functions for the folds: ops::kahan_plus.
+ */
+
+#ifndef FALCON_FOLD_OPS_HPP
+#define FALCON_FOLD_OPS_HPP
+
+#include <falcon/fold/range.hpp>
+
+
+namespace falcon {
+namespace fold {
+namespace ops {
+
+/**
+ * \brief  Compensated sum: \c sum plus the rounding errors in \c compensation
+ */
+template<class T>
+struct kahan_accumulator
+{
+  T sum;
+  T compensation;
+
+  constexpr kahan_accumulator(T x = T())
+  : sum(x)
+  , compensation()
+  {}
+
+  constexpr kahan_accumulator(T s, T c)
+  : sum(s)
+  , compensation(c)
+  {}
+
+  constexpr T value() const {
+    return sum + compensation;
+  }
+
+  constexpr operator T () const {
+    return value();
+  }
+};
+
+/**
+ * \brief  Neumaier summation, usable with all the shapes
+ *
+ * The leaves are floating point values, the result is a \c kahan_accumulator:
+ * \code foldl(kahan_plus{}, 1., 1e100, 1., -1e100).value() \endcode
+ * is \c 2 (\c 0 with \c std::plus).
+ *
+ * Each call adds the exact rounding error of the sum to the compensation.
+ * With \c range_foldt on a contiguous range of \c float or \c double, the
+ * leaves are computed with SIMD (same result as the scalar version).
+ */
+struct kahan_plus
+{
+  template<class T>
+  constexpr kahan_accumulator<T>
+  operator()(T x, T y) const {
+    return add(x, y, T());
+  }
+
+  template<class T>
+  constexpr kahan_accumulator<T>
+  operator()(kahan_accumulator<T> const & x, T y) const {
+    return add(x.sum, y, x.compensation);
+  }
+
+  template<class T>
+  constexpr kahan_accumulator<T>
+  operator()(T x, kahan_accumulator<T> const & y) const {
+    return add(x, y.sum, y.compensation);
+  }
+
+  template<class T>
+  constexpr kahan_accumulator<T>
+  operator()(kahan_accumulator<T> const & x, kahan_accumulator<T> const & y) const {
+    return add(x.sum, y.sum, x.compensation + y.compensation);
+  }
+
+private:
+  template<class T>
+  static constexpr T abs(T x) {
+    return x < T() ? -x : x;
+  }
+
+  template<class T>
+  static constexpr kahan_accumulator<T>
+  add(T x, T y, T c) {
+    return add(x, y, x + y, c);
+  }
+
+  template<class T>
+  static constexpr kahan_accumulator<T>
+  add(T x, T y, T s, T c) {
+    return {s, c + (abs(x) >= abs(y) ? (x - s) + y : (y - s) + x)};
+  }
+};
+
+} // namespace ops
+} // namespace fold
+
+
+// Implementation
+
+#if FALCON_FOLD_RANGE_SIMD
+namespace detail { namespace fold {
+  // The error of a sum is computed with TwoSum (branchless). It is exact,
+  // like the one of kahan_plus, the results are the same.
+
+  struct kahan_ps
+  {
+    __m128 s;
+    __m128 c;
+  };
+
+  // [a0+a1, a2+a3, b0+b1, b2+b3] with the compensations
+  inline kahan_ps
+  simd_kahan_hadd(kahan_ps a, kahan_ps b) {
+    __m128 const x = _mm_shuffle_ps(a.s, b.s, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 const y = _mm_shuffle_ps(a.s, b.s, _MM_SHUFFLE(3, 1, 3, 1));
+    __m128 const c = _mm_add_ps(
+      _mm_shuffle_ps(a.c, b.c, _MM_SHUFFLE(2, 0, 2, 0)),
+      _mm_shuffle_ps(a.c, b.c, _MM_SHUFFLE(3, 1, 3, 1))
+    );
+    __m128 const s = _mm_add_ps(x, y);
+    __m128 const yv = _mm_sub_ps(s, x);
+    __m128 const e = _mm_add_ps(_mm_sub_ps(x, _mm_sub_ps(s, yv)), _mm_sub_ps(y, yv));
+    return {s, _mm_add_ps(c, e)};
+  }
+
+  struct kahan_pd
+  {
+    __m128d s;
+    __m128d c;
+  };
+
+  // [a0+a1, b0+b1] with the compensations
+  inline kahan_pd
+  simd_kahan_hadd(kahan_pd a, kahan_pd b) {
+    __m128d const x = _mm_unpacklo_pd(a.s, b.s);
+    __m128d const y = _mm_unpackhi_pd(a.s, b.s);
+    __m128d const c = _mm_add_pd(_mm_unpacklo_pd(a.c, b.c), _mm_unpackhi_pd(a.c, b.c));
+    __m128d const s = _mm_add_pd(x, y);
+    __m128d const yv = _mm_sub_pd(s, x);
+    __m128d const e = _mm_add_pd(_mm_sub_pd(x, _mm_sub_pd(s, yv)), _mm_sub_pd(y, yv));
+    return {s, _mm_add_pd(c, e)};
+  }
+
+  template<>
+  struct foldt_kernel<::falcon::fold::ops::kahan_plus, float>
+  {
+    static constexpr size_t size = 16;
+
+    static ::falcon::fold::ops::kahan_accumulator<float>
+    impl(float const * p) {
+      __m128 const z = _mm_setzero_ps();
+      kahan_ps const h0 = simd_kahan_hadd({_mm_loadu_ps(p), z}, {_mm_loadu_ps(p + 4), z});
+      kahan_ps const h1 = simd_kahan_hadd({_mm_loadu_ps(p + 8), z}, {_mm_loadu_ps(p + 12), z});
+      kahan_ps const q = simd_kahan_hadd(h0, h1);
+      kahan_ps const o = simd_kahan_hadd(q, q);
+      kahan_ps const r = simd_kahan_hadd(o, o);
+      return {_mm_cvtss_f32(r.s), _mm_cvtss_f32(r.c)};
+    }
+  };
+
+  template<>
+  struct foldt_kernel<::falcon::fold::ops::kahan_plus, double>
+  {
+    static constexpr size_t size = 8;
+
+    static ::falcon::fold::ops::kahan_accumulator<double>
+    impl(double const * p) {
+      __m128d const z = _mm_setzero_pd();
+      kahan_pd const h0 = simd_kahan_hadd({_mm_loadu_pd(p), z}, {_mm_loadu_pd(p + 2), z});
+      kahan_pd const h1 = simd_kahan_hadd({_mm_loadu_pd(p + 4), z}, {_mm_loadu_pd(p + 6), z});
+      kahan_pd const q = simd_kahan_hadd(h0, h1);
+      kahan_pd const r = simd_kahan_hadd(q, q);
+      return {_mm_cvtsd_f64(r.s), _mm_cvtsd_f64(r.c)};
+    }
+  };
+} }
+#endif
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,473 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Fold functions with the independent sub-trees computed in parallel: par_fold, par_foldt, par_range_foldt, par_range_scant and thread_pool.
+ *
+ * An executor is an object with `post(task)`: `task` is a copyable function
+ * without parameter that is called once, from any thread.
+ */
+
+#ifndef FALCON_FOLD_PARALLEL_HPP
+#define FALCON_FOLD_PARALLEL_HPP
+
+#include <falcon/fold.hpp>
+#include <falcon/fold/async.hpp> // AsyncSlot
+#include <falcon/fold/range.hpp>
+
+#include <deque>
+#include <mutex>
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Executor with \a n threads that run the tasks in posting order
+ *
+ * The destructor runs the remaining tasks, then joins the threads.
+ */
+class thread_pool
+{
+public:
+  /// \a n is at least 1. \a init(i) is called first by the thread \c i (affinity, etc)
+  explicit thread_pool(
+    std::size_t n = std::thread::hardware_concurrency(),
+    std::function<void(std::size_t)> init = nullptr);
+  ~thread_pool();
+
+  thread_pool(thread_pool const &) = delete;
+  thread_pool & operator=(thread_pool const &) = delete;
+
+  void post(std::function<void()> task);
+
+  std::size_t size() const noexcept {
+    return threads_.size();
+  }
+
+private:
+  void run(std::function<void(std::size_t)> const & init, std::size_t i);
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+};
+
+/**
+ * \brief  Same result as \c tag_fold<Tag>(f, args...) where the left sub-tree
+ * of each node is posted on \a executor while the right one is computed by
+ * the current thread.
+ *
+ * A sub-tree not yet started when its result is needed is computed by the
+ * waiting thread: a blocked thread always waits for a running task, even
+ * with an executor of 1 thread (or an executor that never runs the tasks).
+ * With 16 arguments and \c foldt_tag, the 8 calls of the first level are
+ * independent.
+ *
+ * \a f is called concurrently and must be thread-safe. The arguments are
+ * not copied. An exception of \a f is rethrown after the end of the posted
+ * sub-trees.
+ */
+template<class Tag, class Executor, class Fn, class... Ts>
+decltype(auto)
+par_fold(Executor & executor, Fn && f, Ts && ... args);
+
+/**
+ * \brief  Shortcut for \c par_fold<foldt_tag>
+ *
+ * \code
+ * thread_pool pool(8);
+ * auto sketch = par_foldt(pool, merge, s1, s2, s3, s4, s5, s6, s7, s8);
+ * \endcode
+ */
+template<class Executor, class Fn, class... Ts>
+decltype(auto)
+par_foldt(Executor & executor, Fn && f, Ts && ... args) {
+  return par_fold<foldt_tag>(executor, std::forward<Fn>(f), std::forward<Ts>(args)...);
+}
+
+/**
+ * \brief  Same result as \c range_foldt(f, first, last) with the
+ * independent sub-ranges computed in parallel
+ *
+ * The range is split as \c range_foldt down to the sub-ranges of \a Grain
+ * elements or less, which are folded with \c range_foldt by one task.
+ * \a Grain is a power of 2 so that these sub-ranges are sub-trees of
+ * \c foldt.
+ */
+template<std::size_t Grain = 16384, class Executor, class Fn, class It>
+range_result_t<Fn, It>
+par_range_foldt(Executor & executor, Fn && f, It first, It last);
+
+/**
+ * \brief  Same output as \c range_scant(f, first, last, out) with the
+ * independent sub-trees of the up-sweep and of the down-sweep computed in
+ * parallel
+ *
+ * The sub-ranges of \a Grain elements or less (a power of 2) are swept with
+ * \c range_scant by one task. \a f is called concurrently on different
+ * elements of \a out.
+ *
+ * \return  end of the output range
+ */
+template<std::size_t Grain = 16384, class Executor, class Fn, class It, class RandomOutIt>
+RandomOutIt
+par_range_scant(Executor & executor, Fn && f, It first, It last, RandomOutIt out);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  /// Sub-tree computed by the executor or by the thread that needs it
+  template<class T, class F>
+  class ParTask
+  {
+  public:
+    explicit ParTask(F f)
+    : f_(std::move(f))
+    {}
+
+    /// by the executor
+    void run() {
+      if (claim()) {
+        execute();
+      }
+    }
+
+    /// by the parent, computed by the current thread when not started
+    T get() {
+      if (claim()) {
+        execute();
+      }
+      else {
+        wait();
+      }
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+      return slot_.take();
+    }
+
+    /// by the parent when the other sub-tree fails
+    void cancel() noexcept {
+      if (!claim()) {
+        wait();
+      }
+    }
+
+  private:
+    bool claim() noexcept {
+      return !started_.exchange(true);
+    }
+
+    void execute() {
+      try {
+        slot_.set(f_());
+      }
+      catch (...) {
+        error_ = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+      }
+      cv_.notify_one();
+    }
+
+    void wait() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]{ return done_; });
+    }
+
+    F f_;
+    AsyncSlot<T> slot_;
+    std::exception_ptr error_;
+    std::atomic<bool> started_ {false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool done_ = false;
+  };
+
+  template<class Task>
+  struct ParCancel
+  {
+    Task * task;
+
+    ~ParCancel() {
+      if (task) {
+        task->cancel();
+      }
+    }
+  };
+
+  /// \a left() is posted on \a ex, \a right() computed by the current thread
+  template<class Ex, class Fn, class L, class R>
+  auto par_join(Ex & ex, Fn & f, L left, R right) {
+    using task_type = ParTask<decltype(left()), L>;
+    auto task = std::make_shared<task_type>(std::move(left));
+    ex.post([task]{ task->run(); });
+    ParCancel<task_type> guard{task.get()};
+    auto && y = right();
+    auto x = task->get();
+    guard.task = nullptr;
+    return f(std::move(x), static_cast<decltype(y)&&>(y));
+  }
+
+  /// N arguments from the index B of the tuple
+  template<class Tag, std::size_t B, std::size_t N>
+  struct ParFold
+  {
+    static constexpr std::size_t m = foldtree_split<Tag, N>::value;
+
+    using left = ParFold<Tag, B, m>;
+    using right = ParFold<Tag, B + m, N - m>;
+
+    template<class Ex, class Fn, class Tuple>
+    static auto impl(Ex & ex, Fn & f, Tuple & t) {
+      return impl(ex, f, t, std::integral_constant<bool, (m > 1)>{});
+    }
+
+  private:
+    template<class Ex, class Fn, class Tuple>
+    static auto impl(Ex & ex, Fn & f, Tuple & t, std::false_type) {
+      return f(left::impl(ex, f, t), right::impl(ex, f, t));
+    }
+
+    template<class Ex, class Fn, class Tuple>
+    static auto impl(Ex & ex, Fn & f, Tuple & t, std::true_type) {
+      return par_join(
+        ex, f,
+        [&ex, &f, &t]{ return left::impl(ex, f, t); },
+        [&ex, &f, &t]() -> decltype(auto) { return right::impl(ex, f, t); }
+      );
+    }
+  };
+
+  template<class Tag, std::size_t B>
+  struct ParFold<Tag, B, 1>
+  {
+    template<class Ex, class Fn, class Tuple>
+    static decltype(auto) impl(Ex &, Fn &, Tuple & t) {
+      return static_cast<std::tuple_element_t<B, Tuple>>(std::get<B>(t));
+    }
+  };
+
+  template<std::size_t Grain, class R, class Ex, class Fn, class It>
+  R par_range_foldt_impl(Ex & ex, Fn & f, It first, std::size_t n)
+  {
+    if (n <= Grain) {
+      return ::falcon::fold::range_foldt(
+        f, first, std::next(first, static_cast<std::ptrdiff_t>(n)));
+    }
+    std::size_t const m = n == 2 ? 1 : count_foldt_element(n);
+    return par_join(
+      ex, f,
+      [&ex, &f, first, m]{ return par_range_foldt_impl<Grain, R>(ex, f, first, m); },
+      [&ex, &f, first, m, n]{
+        return par_range_foldt_impl<Grain, R>(
+          ex, f, std::next(first, static_cast<std::ptrdiff_t>(m)), n - m);
+      }
+    );
+  }
+
+  /// result of the tasks of par_range_scant, which write on the output
+  struct ParScanDone {};
+
+  template<std::size_t Grain, class Ex, class Fn, class It, class OutIt>
+  ParScanDone par_range_scant_up(Ex & ex, Fn & f, It first, OutIt out, std::size_t n)
+  {
+    if (n <= Grain) {
+      range_scant_up(f, first, out, n);
+      return {};
+    }
+    std::size_t const m = ::falcon::fold::foldt_tag::value(n);
+    auto join = [&f, out, m, n](ParScanDone, ParScanDone) {
+      out[n-1] = f(out[m-1], out[n-1]);
+      return ParScanDone{};
+    };
+    return par_join(
+      ex, join,
+      [&ex, &f, first, out, m]{ return par_range_scant_up<Grain>(ex, f, first, out, m); },
+      [&ex, &f, first, out, m, n]{
+        return par_range_scant_up<Grain>(
+          ex, f, std::next(first, static_cast<std::ptrdiff_t>(m)), out + m, n - m);
+      }
+    );
+  }
+
+  template<std::size_t Grain, class Ex, class Fn, class OutIt, class R>
+  ParScanDone par_range_scant_down(Ex & ex, Fn & f, OutIt out, std::size_t n, R const & prefix);
+
+  /// the sub-trees do not modify out[m-1], the prefix of the right one
+  template<std::size_t Grain, class Ex, class Fn, class OutIt>
+  ParScanDone par_range_scant_down(Ex & ex, Fn & f, OutIt out, std::size_t n)
+  {
+    if (n <= Grain) {
+      range_scant_down(f, out, n);
+      return {};
+    }
+    std::size_t const m = ::falcon::fold::foldt_tag::value(n);
+    auto join = [](ParScanDone, ParScanDone) { return ParScanDone{}; };
+    return par_join(
+      ex, join,
+      [&ex, &f, out, m]{ return par_range_scant_down<Grain>(ex, f, out, m); },
+      [&ex, &f, out, m, n]{ return par_range_scant_down<Grain>(ex, f, out + m, n - m, out[m-1]); }
+    );
+  }
+
+  template<std::size_t Grain, class Ex, class Fn, class OutIt, class R>
+  ParScanDone par_range_scant_down(Ex & ex, Fn & f, OutIt out, std::size_t n, R const & prefix)
+  {
+    if (n <= Grain) {
+      range_scant_down(f, out, n, prefix);
+      return {};
+    }
+    std::size_t const m = ::falcon::fold::foldt_tag::value(n);
+    out[m-1] = f(prefix, out[m-1]);
+    auto join = [](ParScanDone, ParScanDone) { return ParScanDone{}; };
+    return par_join(
+      ex, join,
+      [&ex, &f, out, m, &prefix]{ return par_range_scant_down<Grain>(ex, f, out, m, prefix); },
+      [&ex, &f, out, m, n]{ return par_range_scant_down<Grain>(ex, f, out + m, n - m, out[m-1]); }
+    );
+  }
+
+  template<class Tag, class Ex, class Fn, class... Ts>
+  decltype(auto)
+  par_fold(Ex &, Fn && f, std::false_type, Ts && ... args) {
+    return tag_fold<Tag>::impl(std::forward<Fn>(f), std::forward<Ts>(args)...);
+  }
+
+  template<class Tag, class Ex, class Fn, class... Ts>
+  auto
+  par_fold(Ex & ex, Fn && f, std::true_type, Ts && ... args) {
+    auto t = std::forward_as_tuple(std::forward<Ts>(args)...);
+    return ParFold<Tag, 0, sizeof...(Ts)>::impl(ex, f, t);
+  }
+} }
+
+namespace fold {
+  inline thread_pool::thread_pool(std::size_t n, std::function<void(std::size_t)> init) {
+    n = n ? n : 1;
+    threads_.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      threads_.emplace_back([this, init, i]{ run(init, i); });
+    }
+  }
+
+  inline thread_pool::~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto & th : threads_) {
+      th.join();
+    }
+  }
+
+  inline void thread_pool::post(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+  inline void thread_pool::run(std::function<void(std::size_t)> const & init, std::size_t i) {
+    if (init) {
+      init(i);
+    }
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]{ return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  template<class Tag, class Executor, class Fn, class... Ts>
+  decltype(auto)
+  par_fold(Executor & executor, Fn && f, Ts && ... args) {
+    return detail::fold::par_fold<Tag>(
+      executor, std::forward<Fn>(f),
+      std::integral_constant<bool, (sizeof...(Ts) > 2)>{},
+      std::forward<Ts>(args)...
+    );
+  }
+
+  template<std::size_t Grain, class Executor, class Fn, class It>
+  range_result_t<Fn, It>
+  par_range_foldt(Executor & executor, Fn && f, It first, It last) {
+    static_assert(Grain >= 1 && (Grain & (Grain - 1)) == 0, "Grain must be a power of 2");
+    using R = range_result_t<Fn, It>;
+    if (first == last) {
+      return detail::fold::range_empty<R>(f, 1);
+    }
+    return detail::fold::par_range_foldt_impl<Grain, R>(
+      executor, f, first, static_cast<std::size_t>(std::distance(first, last)));
+  }
+
+  template<std::size_t Grain, class Executor, class Fn, class It, class RandomOutIt>
+  RandomOutIt
+  par_range_scant(Executor & executor, Fn && f, It first, It last, RandomOutIt out) {
+    static_assert(Grain >= 1 && (Grain & (Grain - 1)) == 0, "Grain must be a power of 2");
+    std::size_t const n = static_cast<std::size_t>(std::distance(first, last));
+    if (n) {
+      detail::fold::par_range_scant_up<Grain>(executor, f, first, out, n);
+      detail::fold::par_range_scant_down<Grain>(executor, f, out, n);
+    }
+    return out + static_cast<std::ptrdiff_t>(n);
+  }
+} // namespace fold
+
+using fold::thread_pool;
+using fold::par_fold;
+using fold::par_foldt;
+using fold::par_range_foldt;
+using fold::par_range_scant;
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,609 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Fold functions on iterator range with the same shapes as the parameter list versions.
+ *
+ * `f`: Binary function. If the range is empty, is used as a generator (cf: `f()`),
+ *      or a value-initialized result when `f()` is not valid.
+ * `[first, last)`: range of values (forward iterators)
+ *
+ * The result type is `std::decay_t<decltype(f(*first, *first))>`.
+ */
+
+#ifndef FALCON_FOLD_RANGE_HPP
+#define FALCON_FOLD_RANGE_HPP
+
+#include <falcon/fold.hpp>
+
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <functional> // std::plus
+
+#ifndef FALCON_FOLD_RANGE_SIMD
+# if defined(__x86_64__) or defined(_M_X64)
+#  define FALCON_FOLD_RANGE_SIMD 1
+# else
+#  define FALCON_FOLD_RANGE_SIMD 0
+# endif
+#endif
+
+#if FALCON_FOLD_RANGE_SIMD
+# include <emmintrin.h>
+#endif
+
+
+namespace falcon {
+namespace fold {
+
+template<class Fn, class It>
+using range_result_t = std::decay_t<decltype(
+  std::declval<Fn&>()(*std::declval<It&>(), *std::declval<It&>())
+)>;
+
+/**
+ * \brief  Apply \a f from left to right on [first, last)
+ *
+ * \code range_foldl(f, first, last) \endcode
+ * equivalent to
+ * \code foldl(f, first[0], first[1], ..., last[-1]) \endcode
+ */
+template<class Fn, class It>
+range_result_t<Fn, It>
+range_foldl(Fn && f, It first, It last);
+
+/**
+ * \brief  Apply \a f as a nested sub-expressions on [first, last)
+ *
+ * With \c std::plus on a contiguous range (pointers) of \c float, \c double,
+ * \c int32_t or \c int64_t, the leaves are computed with SIMD shuffles
+ * that follow the pairing order of \c foldt (same result as the scalar version).
+ *
+ * \code range_foldt(f, first, last) \endcode
+ * equivalent to
+ * \code foldt(f, first[0], first[1], ..., last[-1]) \endcode
+ */
+template<class Fn, class It>
+range_result_t<Fn, It>
+range_foldt(Fn && f, It first, It last);
+
+/**
+ * \brief  Apply \a f as \c foldbl on [first, last)
+ *
+ * The sub-ranges of \a Cutoff elements or less are folded with an unrolled
+ * tree (same association order as \c foldbl), each element is read once.
+ *
+ * \code range_foldbl(f, first, last) \endcode
+ * equivalent to
+ * \code foldbl(f, first[0], first[1], ..., last[-1]) \endcode
+ */
+template<std::size_t Cutoff = 16, class Fn, class It>
+range_result_t<Fn, It>
+range_foldbl(Fn && f, It first, It last);
+
+/**
+ * \brief  Apply \a f as \c foldbr on [first, last)
+ *
+ * Same as \c range_foldbl with the shape of \c foldbr.
+ *
+ * \code range_foldbr(f, first, last) \endcode
+ * equivalent to
+ * \code foldbr(f, first[0], first[1], ..., last[-1]) \endcode
+ */
+template<std::size_t Cutoff = 16, class Fn, class It>
+range_result_t<Fn, It>
+range_foldbr(Fn && f, It first, It last);
+
+/**
+ * \brief  Apply \a f as \c foldp on [first, last): groups of \a First
+ * elements, then \a First * \a Factor, \a First * \a Factor^2, etc.
+ *
+ * \a folder(group_first, group_last) is called on each group, except on the
+ * first element when \a First is 1 (as \c foldp), and returns a value
+ * convertible to the result.
+ *
+ * \code range_foldp<4, 16>(folder, f, first, last) \endcode
+ * equivalent to
+ * \code f(folder(first, first+16), f(folder(first+16, first+80), ...)) \endcode
+ */
+template<std::size_t Factor = 2, std::size_t First = 1, class Folder, class Fn, class It>
+range_result_t<Fn, It>
+range_foldp(Folder && folder, Fn && f, It first, It last);
+
+
+/**
+ * \brief  Partial results of \c range_foldl
+ *
+ * \code range_scanl(f, first, last, out) \endcode
+ * equivalent to
+ * \code out[0] = first[0]; out[i] = f(out[i-1], first[i]); \endcode
+ * \return  end of the output range
+ */
+template<class Fn, class It, class OutIt>
+OutIt
+range_scanl(Fn && f, It first, It last, OutIt out);
+
+/**
+ * \brief  Partial results with a work-efficient tree (Blelloch scan on the shape of \c foldt)
+ *
+ * The last value is \c range_foldt(f, first, last).
+ * An up-sweep computes the totals of the sub-trees, a down-sweep propagates
+ * the prefixes. \a f is called up to 2*n times (n-1 times with
+ * \c range_scanl): the interest is that each step processes two independent
+ * sub-trees, which \c par_range_scant computes in parallel.
+ *
+ * When \a f is associative, the output is the same as \c range_scanl.
+ *
+ * \return  end of the output range
+ */
+template<class Fn, class It, class RandomOutIt>
+RandomOutIt
+range_scant(Fn && f, It first, It last, RandomOutIt out);
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  struct no_foldt_kernel
+  {
+    static constexpr size_t size = 0;
+  };
+
+  /// Fold \c size contiguous elements with the shape of foldt
+  template<class Fn, class T>
+  struct foldt_kernel : no_foldt_kernel
+  {};
+
+#if FALCON_FOLD_RANGE_SIMD
+  // hadd(a, b) = [a0+a1, a2+a3, b0+b1, b2+b3]
+  inline __m128
+  simd_hadd(__m128 a, __m128 b) {
+    return _mm_add_ps(
+      _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+      _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))
+    );
+  }
+
+  // hadd(a, b) = [a0+a1, b0+b1]
+  inline __m128d
+  simd_hadd(__m128d a, __m128d b) {
+    return _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+  }
+
+  inline __m128i
+  simd_hadd_epi32(__m128i a, __m128i b) {
+    __m128 const fa = _mm_castsi128_ps(a);
+    __m128 const fb = _mm_castsi128_ps(b);
+    return _mm_add_epi32(
+      _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0))),
+      _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)))
+    );
+  }
+
+  inline __m128i
+  simd_hadd_epi64(__m128i a, __m128i b) {
+    return _mm_add_epi64(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+  }
+
+  inline __m128i
+  simd_load(std::int32_t const * p) {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+  }
+
+  inline __m128i
+  simd_load(std::int64_t const * p) {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+  }
+
+  template<class T>
+  struct plus_foldt_kernel : no_foldt_kernel
+  {};
+
+  template<>
+  struct plus_foldt_kernel<float>
+  {
+    static constexpr size_t size = 16;
+
+    static float
+    impl(float const * p) {
+      __m128 const h0 = simd_hadd(_mm_loadu_ps(p), _mm_loadu_ps(p + 4));
+      __m128 const h1 = simd_hadd(_mm_loadu_ps(p + 8), _mm_loadu_ps(p + 12));
+      __m128 const q = simd_hadd(h0, h1);
+      __m128 const o = simd_hadd(q, q);
+      return _mm_cvtss_f32(simd_hadd(o, o));
+    }
+  };
+
+  template<>
+  struct plus_foldt_kernel<double>
+  {
+    static constexpr size_t size = 8;
+
+    static double
+    impl(double const * p) {
+      __m128d const h0 = simd_hadd(_mm_loadu_pd(p), _mm_loadu_pd(p + 2));
+      __m128d const h1 = simd_hadd(_mm_loadu_pd(p + 4), _mm_loadu_pd(p + 6));
+      __m128d const q = simd_hadd(h0, h1);
+      return _mm_cvtsd_f64(simd_hadd(q, q));
+    }
+  };
+
+  template<>
+  struct plus_foldt_kernel<std::int32_t>
+  {
+    static constexpr size_t size = 16;
+
+    static std::int32_t
+    impl(std::int32_t const * p) {
+      __m128i const h0 = simd_hadd_epi32(simd_load(p), simd_load(p + 4));
+      __m128i const h1 = simd_hadd_epi32(simd_load(p + 8), simd_load(p + 12));
+      __m128i const q = simd_hadd_epi32(h0, h1);
+      __m128i const o = simd_hadd_epi32(q, q);
+      return _mm_cvtsi128_si32(simd_hadd_epi32(o, o));
+    }
+  };
+
+  template<>
+  struct plus_foldt_kernel<std::int64_t>
+  {
+    static constexpr size_t size = 8;
+
+    static std::int64_t
+    impl(std::int64_t const * p) {
+      __m128i const h0 = simd_hadd_epi64(simd_load(p), simd_load(p + 2));
+      __m128i const h1 = simd_hadd_epi64(simd_load(p + 4), simd_load(p + 6));
+      __m128i const q = simd_hadd_epi64(h0, h1);
+      return _mm_cvtsi128_si64(simd_hadd_epi64(q, q));
+    }
+  };
+
+  template<class T>
+  struct foldt_kernel<std::plus<T>, T> : plus_foldt_kernel<T>
+  {};
+
+  template<class T>
+  struct foldt_kernel<std::plus<>, T> : plus_foldt_kernel<T>
+  {};
+#endif
+
+  template<class R, class Fn>
+  auto range_empty(Fn & f, int) -> decltype(R(f())) {
+    return f();
+  }
+
+  template<class R, class Fn>
+  R range_empty(Fn &, char) {
+    return R();
+  }
+
+  template<class Fn, class It>
+  struct range_foldt_kernel
+  { using type = no_foldt_kernel; };
+
+  template<class Fn, class T>
+  struct range_foldt_kernel<Fn, T*>
+  { using type = foldt_kernel<std::decay_t<Fn>, std::remove_const_t<T>>; };
+
+  template<class R, class Kernel, class Fn, class It>
+  R range_foldt_impl(Fn & f, It first, size_t n, std::false_type)
+  {
+    if (n == 1) {
+      return R(*first);
+    }
+    if (n == 2) {
+      return f(*first, *std::next(first));
+    }
+    size_t const m = count_foldt_element(n);
+    return f(
+      range_foldt_impl<R, Kernel>(f, first, m, std::false_type{}),
+      range_foldt_impl<R, Kernel>(
+        f, std::next(first, static_cast<std::ptrdiff_t>(m)), n - m, std::false_type{})
+    );
+  }
+
+  template<class R, class Kernel, class Fn, class It>
+  R range_foldt_impl(Fn & f, It first, size_t n, std::true_type)
+  {
+    if (n == Kernel::size) {
+      return Kernel::impl(first);
+    }
+    if (n < Kernel::size) {
+      return range_foldt_impl<R, Kernel>(f, first, n, std::false_type{});
+    }
+    size_t const m = count_foldt_element(n);
+    return f(
+      range_foldt_impl<R, Kernel>(f, first, m, std::true_type{}),
+      range_foldt_impl<R, Kernel>(f, first + m, n - m, std::true_type{})
+    );
+  }
+
+  // unrolled tree of N elements with the splits of foldtree<Policy>
+  template<class Policy, size_t N>
+  struct range_foldtree_leaf
+  {
+    static constexpr size_t m = foldtree_split<Policy, N>::value;
+
+    template<class R, class Fn, class It>
+    static R impl(Fn & f, It & it)
+    {
+      R r = range_foldtree_leaf<Policy, m>::template impl<R>(f, it);
+      return f(std::move(r), range_foldtree_leaf<Policy, N - m>::template impl<R>(f, it));
+    }
+  };
+
+  template<class Policy>
+  struct range_foldtree_leaf<Policy, 2>
+  {
+    template<class R, class Fn, class It>
+    static R impl(Fn & f, It & it)
+    {
+      It const first = it;
+      R r = f(*first, *++it);
+      ++it;
+      return r;
+    }
+  };
+
+  template<class Policy>
+  struct range_foldtree_leaf<Policy, 1>
+  {
+    template<class R, class Fn, class It>
+    static R impl(Fn &, It & it)
+    {
+      R r(*it);
+      ++it;
+      return r;
+    }
+  };
+
+  template<class R, class Policy, class Fn, class It, size_t... I>
+  R range_foldtree_leaves(Fn & f, It first, size_t n, std::index_sequence<I...>)
+  {
+    using leaf_fn = R(Fn &, It &);
+    static leaf_fn * const leaves[] {
+      &range_foldtree_leaf<Policy, I + 1>::template impl<R, Fn, It>...
+    };
+    return leaves[n - 1](f, first);
+  }
+
+  template<class R, class Policy, size_t Cutoff, class Fn, class It>
+  R range_foldtree_impl(Fn & f, It first, size_t n)
+  {
+    if (n <= Cutoff) {
+      return range_foldtree_leaves<R, Policy>(f, first, n, std::make_index_sequence<Cutoff>{});
+    }
+    size_t const m = Policy::value(n);
+    return f(
+      range_foldtree_impl<R, Policy, Cutoff>(f, first, m),
+      range_foldtree_impl<R, Policy, Cutoff>(
+        f, std::next(first, static_cast<std::ptrdiff_t>(m)), n - m)
+    );
+  }
+
+  template<class Policy, size_t Cutoff, class Fn, class It>
+  ::falcon::fold::range_result_t<Fn, It>
+  range_foldtree(Fn & f, It first, It last)
+  {
+    static_assert(Cutoff >= 1, "Cutoff must be greater than 0");
+    using R = ::falcon::fold::range_result_t<Fn, It>;
+    if (first == last) {
+      return range_empty<R>(f, 1);
+    }
+    return range_foldtree_impl<R, Policy, Cutoff>(
+      f, first, static_cast<size_t>(std::distance(first, last)));
+  }
+
+  /// \a k groups from \a starts, folded from right to left
+  template<class R, class Folder, class Fn, class It>
+  R range_foldp_groups(Folder & folder, Fn & f, It const * starts, size_t k, It last, size_t n)
+  {
+    // as foldp: a group of 1 element is passed as is when it is the first
+    // one or with 2 elements
+    auto group = [&folder, n](size_t i, It first, It group_last) {
+      return ((i == 0 || n == 2) && std::next(first) == group_last)
+        ? R(*first) : R(folder(first, group_last));
+    };
+    R r = group(k - 1, starts[k - 1], last);
+    for (size_t i = k - 1; i-- > 0;) {
+      r = f(group(i, starts[i], starts[i + 1]), std::move(r));
+    }
+    return r;
+  }
+
+  template<class R, size_t Factor, class Folder, class Fn, class It>
+  R range_foldp_impl(Folder & folder, Fn & f, It first, It last, size_t size, size_t n, std::false_type)
+  {
+    // the sizes are multiplied by 2 or more: less groups than bits of n
+    It starts[std::numeric_limits<size_t>::digits];
+    size_t k = 0;
+    for (size_t remaining = n;; size *= Factor) {
+      starts[k++] = first;
+      if (remaining <= size) {
+        break;
+      }
+      std::advance(first, static_cast<std::ptrdiff_t>(size));
+      remaining -= size;
+    }
+    return range_foldp_groups<R>(folder, f, starts, k, last, n);
+  }
+
+  /// Factor == 1: n / size groups
+  template<class R, size_t Factor, class Folder, class Fn, class It>
+  R range_foldp_impl(Folder & folder, Fn & f, It first, It last, size_t size, size_t n, std::true_type)
+  {
+    std::vector<It> starts;
+    starts.reserve((n + size - 1) / size);
+    for (size_t remaining = n;;) {
+      starts.push_back(first);
+      if (remaining <= size) {
+        break;
+      }
+      std::advance(first, static_cast<std::ptrdiff_t>(size));
+      remaining -= size;
+    }
+    return range_foldp_groups<R>(folder, f, starts.data(), starts.size(), last, n);
+  }
+
+  template<class Fn, class It, class OutIt>
+  void range_scant_up(Fn & f, It first, OutIt out, size_t n)
+  {
+    if (n == 1) {
+      *out = *first;
+      return;
+    }
+    size_t const m = ::falcon::fold::foldt_tag::value(n);
+    range_scant_up(f, first, out, m);
+    range_scant_up(f, std::next(first, static_cast<std::ptrdiff_t>(m)), out + m, n - m);
+    // totals of the sub-trees are on the last element
+    out[n-1] = f(out[m-1], out[n-1]);
+  }
+
+  template<class Fn, class OutIt, class R>
+  void range_scant_down(Fn & f, OutIt out, size_t n, R const & prefix);
+
+  template<class Fn, class OutIt>
+  void range_scant_down(Fn & f, OutIt out, size_t n)
+  {
+    if (n == 1) {
+      return;
+    }
+    size_t const m = ::falcon::fold::foldt_tag::value(n);
+    range_scant_down(f, out, m);
+    range_scant_down(f, out + m, n - m, out[m-1]);
+  }
+
+  template<class Fn, class OutIt, class R>
+  void range_scant_down(Fn & f, OutIt out, size_t n, R const & prefix)
+  {
+    if (n == 1) {
+      return;
+    }
+    size_t const m = ::falcon::fold::foldt_tag::value(n);
+    out[m-1] = f(prefix, out[m-1]);
+    range_scant_down(f, out, m, prefix);
+    range_scant_down(f, out + m, n - m, out[m-1]);
+  }
+} }
+
+namespace fold {
+  template<class Fn, class It>
+  range_result_t<Fn, It>
+  range_foldl(Fn && f, It first, It last) {
+    using R = range_result_t<Fn, It>;
+    if (first == last) {
+      return detail::fold::range_empty<R>(f, 1);
+    }
+    It it = first;
+    if (++it == last) {
+      return R(*first);
+    }
+    R r = f(*first, *it);
+    while (++it != last) {
+      r = f(std::move(r), *it);
+    }
+    return r;
+  }
+
+  template<class Fn, class It>
+  range_result_t<Fn, It>
+  range_foldt(Fn && f, It first, It last) {
+    using R = range_result_t<Fn, It>;
+    if (first == last) {
+      return detail::fold::range_empty<R>(f, 1);
+    }
+    using Kernel = typename detail::fold::range_foldt_kernel<Fn, It>::type;
+    return detail::fold::range_foldt_impl<R, Kernel>(
+      f, first, static_cast<size_t>(std::distance(first, last)),
+      std::integral_constant<bool, Kernel::size != 0>{}
+    );
+  }
+
+  template<std::size_t Cutoff, class Fn, class It>
+  range_result_t<Fn, It>
+  range_foldbl(Fn && f, It first, It last) {
+    return detail::fold::range_foldtree<foldbl_tag, Cutoff>(f, first, last);
+  }
+
+  template<std::size_t Cutoff, class Fn, class It>
+  range_result_t<Fn, It>
+  range_foldbr(Fn && f, It first, It last) {
+    return detail::fold::range_foldtree<foldbr_tag, Cutoff>(f, first, last);
+  }
+
+  template<std::size_t Factor, std::size_t First, class Folder, class Fn, class It>
+  range_result_t<Fn, It>
+  range_foldp(Folder && folder, Fn && f, It first, It last) {
+    static_assert(Factor >= 1 && First >= 1, "Factor and First must be greater than 0");
+    using R = range_result_t<Fn, It>;
+    if (first == last) {
+      return detail::fold::range_empty<R>(f, 1);
+    }
+    return detail::fold::range_foldp_impl<R, Factor>(
+      folder, f, first, last, First, static_cast<size_t>(std::distance(first, last)),
+      std::integral_constant<bool, Factor == 1>{});
+  }
+
+  template<class Fn, class It, class OutIt>
+  OutIt
+  range_scanl(Fn && f, It first, It last, OutIt out) {
+    if (first == last) {
+      return out;
+    }
+    range_result_t<Fn, It> r = *first;
+    *out = r;
+    while (++first != last) {
+      r = f(std::move(r), *first);
+      *++out = r;
+    }
+    return ++out;
+  }
+
+  template<class Fn, class It, class RandomOutIt>
+  RandomOutIt
+  range_scant(Fn && f, It first, It last, RandomOutIt out) {
+    size_t const n = static_cast<size_t>(std::distance(first, last));
+    if (n) {
+      detail::fold::range_scant_up(f, first, out, n);
+      detail::fold::range_scant_down(f, out, n);
+    }
+    return out + static_cast<std::ptrdiff_t>(n);
+  }
+} // namespace fold
+
+using fold::range_foldl;
+using fold::range_foldt;
+using fold::range_foldbl;
+using fold::range_foldbr;
+using fold::range_foldp;
+using fold::range_scanl;
+using fold::range_scant;
+
+} // namespace falcon
+
+#endif
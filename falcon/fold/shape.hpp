@@ -0,0 +1,171 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Shape of the folds as a compile-time tree: shape and foldp_shape.
+ */
+
+#ifndef FALCON_FOLD_SHAPE_HPP
+#define FALCON_FOLD_SHAPE_HPP
+
+#include <falcon/fold.hpp>
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Tree of the calls of \c f with the shape \a Tag and \a N arguments
+ *
+ * The splits are the ones of \c foldtree<Tag>: \a Tag is a shape tag
+ * (\c foldt_tag, ...) or a split policy.
+ *
+ * - \c size: number of leaves (\a N)
+ * - \c depth: critical path, number of calls of \c f from the deepest leaf to the root
+ * - \c calls: number of calls of \c f
+ * - \c width(level): number of sub-trees at \c level (\c 0 is the root)
+ * - \c is_leaf
+ * - \c left, \c right and \c split (\c left::size) when \c size is greater than 1
+ *
+ * \code static_assert(shape<foldt_tag, 5>::depth == 3, ""); \endcode
+ */
+template<class Tag, std::size_t N>
+struct shape;
+
+/**
+ * \brief  Tree of the calls of \c foldp<Factor, First> with \a N arguments
+ * and a \c folder with the shape \a FolderTag
+ *
+ * The groups given to \c folder are sub-trees (\c shape<FolderTag, n>),
+ * a group of 1 element is a leaf as the first element.
+ */
+template<std::size_t N, class FolderTag = foldt_tag, std::size_t Factor = 2, std::size_t First = 1>
+struct foldp_shape;
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  struct shape_empty
+  {
+    static constexpr size_t size = 0;
+    static constexpr size_t depth = 0;
+    static constexpr size_t calls = 0;
+    static constexpr bool is_leaf = false;
+
+    static constexpr size_t width(size_t) {
+      return 0;
+    }
+  };
+
+  struct shape_leaf
+  {
+    static constexpr size_t size = 1;
+    static constexpr size_t depth = 0;
+    static constexpr size_t calls = 0;
+    static constexpr bool is_leaf = true;
+
+    static constexpr size_t width(size_t level) {
+      return level == 0;
+    }
+  };
+
+  template<class L, class R>
+  struct shape_node
+  {
+    using left = L;
+    using right = R;
+
+    static constexpr size_t split = L::size;
+    static constexpr size_t size = L::size + R::size;
+    static constexpr size_t depth = 1 + (L::depth < R::depth ? R::depth : L::depth);
+    static constexpr size_t calls = 1 + L::calls + R::calls;
+    static constexpr bool is_leaf = false;
+
+    static constexpr size_t width(size_t level) {
+      return level == 0 ? 1 : L::width(level - 1) + R::width(level - 1);
+    }
+  };
+
+  template<class Tag, size_t N>
+  struct shape_base
+  {
+    using type = shape_node<
+      ::falcon::fold::shape<Tag, foldtree_split<Tag, N>::value>,
+      ::falcon::fold::shape<Tag, N - foldtree_split<Tag, N>::value>
+    >;
+  };
+
+  template<class Tag>
+  struct shape_base<Tag, 0>
+  { using type = shape_empty; };
+
+  template<class Tag>
+  struct shape_base<Tag, 1>
+  { using type = shape_leaf; };
+
+  // groups of Size elements (or less for the last), then Size * Factor, etc.
+  template<class FolderTag, size_t Size, size_t Factor, size_t N, bool = (Size < N)>
+  struct foldp_groups
+  : shape_node<
+    ::falcon::fold::shape<FolderTag, Size>,
+    foldp_groups<FolderTag, Size * Factor, Factor, N - Size>
+  >
+  {};
+
+  template<class FolderTag, size_t Size, size_t Factor, size_t N>
+  struct foldp_groups<FolderTag, Size, Factor, N, false>
+  : ::falcon::fold::shape<FolderTag, N>
+  {};
+
+  template<class FolderTag, size_t Factor, size_t First, size_t N>
+  struct foldp_shape_base
+  { using type = foldp_groups<FolderTag, First, Factor, N>; };
+
+  template<class FolderTag, size_t Factor, size_t First>
+  struct foldp_shape_base<FolderTag, Factor, First, 0>
+  { using type = shape_empty; };
+} }
+
+namespace fold {
+  template<class Tag, std::size_t N>
+  struct shape
+  : detail::fold::shape_base<Tag, N>::type
+  {};
+
+  template<std::size_t N, class FolderTag, std::size_t Factor, std::size_t First>
+  struct foldp_shape
+  : detail::fold::foldp_shape_base<FolderTag, Factor, First, N>::type
+  {};
+} // namespace fold
+
+using fold::shape;
+using fold::foldp_shape;
+
+} // namespace falcon
+
+#endif
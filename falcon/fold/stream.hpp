@@ -0,0 +1,431 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2015 Jonathan Poelen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * \author    Jonathan Poelen <jonathan.poelen+fold@gmail.com>
+ * \version   1.0
+ * \brief     Fold functions on the records of a stream read by chunks: foldt_state and fold_stream.
+ *
+ * A thread reads the next chunk while the current one is folded (double buffering).
+ */
+
+#ifndef FALCON_FOLD_STREAM_HPP
+#define FALCON_FOLD_STREAM_HPP
+
+#include <falcon/fold/range.hpp>
+#include <falcon/fold/async.hpp> // AsyncSlot
+
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <istream>
+#include <utility>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+#include <condition_variable>
+
+#ifndef FALCON_FOLD_FD
+# if defined(__unix__) or defined(__APPLE__)
+#  define FALCON_FOLD_FD 1
+# else
+#  define FALCON_FOLD_FD 0
+# endif
+#endif
+
+#if FALCON_FOLD_FD
+# include <cerrno>
+# include <unistd.h>
+#endif
+
+
+namespace falcon {
+namespace fold {
+
+/**
+ * \brief  Partial results of a \c foldt computed by consecutive blocks
+ *
+ * Each block is the \c foldt of a number of elements that is a power of 2
+ * and not greater than the previous one, except the last block which is
+ * smaller. Two sub-trees of the same size are combined when the second is
+ * pushed, so there are O(log n) partial results and \c result() is the
+ * \c foldt of all elements.
+ */
+template<class R>
+class foldt_state
+{
+public:
+  foldt_state() = default;
+
+  /// restore the \c subtrees() of another state
+  explicit foldt_state(std::vector<std::pair<std::size_t, R>> subtrees)
+  : trees_(std::move(subtrees))
+  {}
+
+  /// \a x is the \c foldt of \a n elements
+  template<class Fn>
+  void push(Fn & f, R x, std::size_t n);
+
+  /// \c foldt of the pushed elements. \pre !empty()
+  template<class Fn>
+  R result(Fn & f);
+
+  bool empty() const noexcept {
+    return trees_.empty();
+  }
+
+  /// number of elements
+  std::size_t size() const noexcept;
+
+  /// (number of elements, result) of each sub-tree, from left to right
+  std::vector<std::pair<std::size_t, R>> const & subtrees() const noexcept {
+    return trees_;
+  }
+
+private:
+  std::vector<std::pair<std::size_t, R>> trees_;
+};
+
+/**
+ * \brief  Apply \a f with the shape of \a Tag on the records read in \a in
+ *
+ * The stream is a sequence of \a Record (trivially copyable) read by chunks
+ * of \a chunk_size records, one chunk being read while the previous one is
+ * folded. \a Tag is \c foldl_tag or \c foldt_tag: the result is the same as
+ * \c range_foldl or \c range_foldt on all the records. With \c foldt_tag,
+ * \a chunk_size is rounded down to a power of 2.
+ *
+ * \throw std::runtime_error when the stream ends in the middle of a record
+ * \throw std::ios_base::failure when the stream is bad
+ */
+template<class Record, class Tag = foldl_tag, class Fn>
+range_result_t<Fn, Record const *>
+fold_stream(std::istream & in, std::size_t chunk_size, Fn && f, Tag = Tag{});
+
+#if FALCON_FOLD_FD
+/**
+ * \brief  Same as \c fold_stream with an \c std::istream, from the current
+ * offset of the file descriptor \a fd to the end
+ *
+ * A regular file is read with \c pread (the offset of \a fd is not modified),
+ * a pipe or a socket with \c read.
+ *
+ * \throw std::system_error when a read fails
+ */
+template<class Record, class Tag = foldl_tag, class Fn>
+range_result_t<Fn, Record const *>
+fold_stream(int fd, std::size_t chunk_size, Fn && f, Tag = Tag{});
+#endif
+
+} // namespace fold
+
+
+// Implementation
+
+namespace detail { namespace fold {
+  struct StreamBuffer
+  {
+    std::unique_ptr<char[]> data;
+    std::size_t size = 0;
+    bool ready = false;
+  };
+
+  /// \a read(p, n) returns the number of bytes read, 0 at the end
+  template<class Read>
+  std::size_t fill_buffer(Read & read, char * p, std::size_t n)
+  {
+    std::size_t filled = 0;
+    while (filled < n) {
+      std::size_t const r = read(p + filled, n - filled);
+      if (!r) {
+        break;
+      }
+      filled += r;
+    }
+    return filled;
+  }
+
+  /**
+   * \a consume(p, n) is called on consecutive buffers of \a chunk_bytes
+   * bytes, the last one is smaller (possibly empty) and is followed by no call.
+   * The next buffer is read by another thread during \a consume.
+   */
+  template<class Read, class Consume>
+  void double_buffered_read(Read read, std::size_t chunk_bytes, Consume consume)
+  {
+    StreamBuffer buffers[2];
+    for (StreamBuffer & buffer : buffers) {
+      buffer.data.reset(new char[chunk_bytes]);
+    }
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error;
+    bool stop = false;
+
+    std::thread reader([&]{
+      for (std::size_t i = 0; ; i ^= 1) {
+        StreamBuffer & buffer = buffers[i];
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cv.wait(lock, [&]{ return !buffer.ready || stop; });
+          if (stop) {
+            return;
+          }
+        }
+        std::size_t n = 0;
+        std::exception_ptr e;
+        try {
+          n = fill_buffer(read, buffer.data.get(), chunk_bytes);
+        }
+        catch (...) {
+          e = std::current_exception();
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          buffer.size = n;
+          buffer.ready = true;
+          error = e;
+        }
+        cv.notify_all();
+        if (e || n < chunk_bytes) {
+          return;
+        }
+      }
+    });
+
+    struct Join
+    {
+      std::thread & reader;
+      std::mutex & mutex;
+      std::condition_variable & cv;
+      bool & stop;
+
+      ~Join() {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop = true;
+        }
+        cv.notify_all();
+        reader.join();
+      }
+    } join{reader, mutex, cv, stop};
+
+    for (std::size_t i = 0; ; i ^= 1) {
+      StreamBuffer & buffer = buffers[i];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]{ return buffer.ready; });
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+      if (buffer.size) {
+        consume(buffer.data.get(), buffer.size);
+      }
+      if (buffer.size < chunk_bytes) {
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.ready = false;
+      }
+      cv.notify_all();
+    }
+  }
+
+  template<class R, class Fn, class Tag>
+  struct StreamFolder;
+
+  template<class R, class Fn>
+  struct StreamFolder<R, Fn, ::falcon::fold::foldl_tag>
+  {
+    Fn & f;
+    AsyncSlot<R> r;
+
+    static std::size_t chunk_size(std::size_t n) {
+      return n;
+    }
+
+    template<class Record>
+    void operator()(Record const * first, Record const * last) {
+      if (!r.has_value()) {
+        r.set(::falcon::fold::range_foldl(f, first, last));
+        return;
+      }
+      for (; first != last; ++first) {
+        r.get() = f(std::move(r.get()), *first);
+      }
+    }
+
+    R result() {
+      return r.has_value() ? r.take() : range_empty<R>(f, 1);
+    }
+  };
+
+  template<class R, class Fn>
+  struct StreamFolder<R, Fn, ::falcon::fold::foldt_tag>
+  {
+    Fn & f;
+    ::falcon::fold::foldt_state<R> state;
+
+    // the power of 2 less than or equal to n
+    static std::size_t chunk_size(std::size_t n) {
+      std::size_t p = 1;
+      while (p <= n / 2) {
+        p *= 2;
+      }
+      return p;
+    }
+
+    template<class Record>
+    void operator()(Record const * first, Record const * last) {
+      state.push(
+        f, ::falcon::fold::range_foldt(f, first, last),
+        static_cast<std::size_t>(last - first));
+    }
+
+    R result() {
+      return state.empty() ? range_empty<R>(f, 1) : state.result(f);
+    }
+  };
+
+  template<class Record, class Tag, class Fn, class Read>
+  ::falcon::fold::range_result_t<Fn, Record const *>
+  fold_stream(Read read, std::size_t chunk_size, Fn & f)
+  {
+    static_assert(std::is_trivially_copyable<Record>::value, "Record must be trivially copyable");
+    static_assert(alignof(Record) <= alignof(std::max_align_t), "Record is over-aligned");
+    using R = ::falcon::fold::range_result_t<Fn, Record const *>;
+    using Folder = StreamFolder<R, Fn, Tag>;
+    Folder folder{f, {}};
+    std::size_t const n = Folder::chunk_size(chunk_size ? chunk_size : 1);
+    double_buffered_read(read, n * sizeof(Record), [&folder](char const * p, std::size_t size) {
+      if (size % sizeof(Record)) {
+        throw std::runtime_error("fold_stream: the stream ends in the middle of a record");
+      }
+      auto const first = reinterpret_cast<Record const *>(p);
+      folder(first, first + size / sizeof(Record));
+    });
+    return folder.result();
+  }
+
+  struct IStreamRead
+  {
+    std::istream & in;
+
+    std::size_t operator()(char * p, std::size_t n) {
+      in.read(p, static_cast<std::streamsize>(n));
+      if (in.bad()) {
+        throw std::ios_base::failure("fold_stream: read error");
+      }
+      return static_cast<std::size_t>(in.gcount());
+    }
+  };
+
+#if FALCON_FOLD_FD
+  struct FdRead
+  {
+    int fd;
+    off_t offset;
+
+    std::size_t operator()(char * p, std::size_t n) {
+      for (;;) {
+        ssize_t const r = offset == -1
+          ? ::read(fd, p, n)
+          : ::pread(fd, p, n, offset);
+        if (r >= 0) {
+          if (offset != -1) {
+            offset += r;
+          }
+          return static_cast<std::size_t>(r);
+        }
+        if (errno != EINTR) {
+          throw std::system_error(errno, std::generic_category(), "fold_stream: read");
+        }
+      }
+    }
+  };
+#endif
+} }
+
+namespace fold {
+  template<class R>
+  template<class Fn>
+  void foldt_state<R>::push(Fn & f, R x, std::size_t n) {
+    while (!trees_.empty() && trees_.back().first == n) {
+      x = f(std::move(trees_.back().second), std::move(x));
+      trees_.pop_back();
+      n *= 2;
+    }
+    trees_.emplace_back(n, std::move(x));
+  }
+
+  template<class R>
+  template<class Fn>
+  R foldt_state<R>::result(Fn & f) {
+    R r = std::move(trees_.back().second);
+    trees_.pop_back();
+    while (!trees_.empty()) {
+      r = f(std::move(trees_.back().second), std::move(r));
+      trees_.pop_back();
+    }
+    return r;
+  }
+
+  template<class R>
+  std::size_t foldt_state<R>::size() const noexcept {
+    std::size_t n = 0;
+    for (auto const & tree : trees_) {
+      n += tree.first;
+    }
+    return n;
+  }
+
+  template<class Record, class Tag, class Fn>
+  range_result_t<Fn, Record const *>
+  fold_stream(std::istream & in, std::size_t chunk_size, Fn && f, Tag) {
+    return detail::fold::fold_stream<Record, Tag>(
+      detail::fold::IStreamRead{in}, chunk_size, f);
+  }
+
+#if FALCON_FOLD_FD
+  template<class Record, class Tag, class Fn>
+  range_result_t<Fn, Record const *>
+  fold_stream(int fd, std::size_t chunk_size, Fn && f, Tag) {
+    // -1 (not seekable): read
+    off_t const offset = ::lseek(fd, 0, SEEK_CUR);
+    return detail::fold::fold_stream<Record, Tag>(
+      detail::fold::FdRead{fd, offset}, chunk_size, f);
+  }
+#endif
+} // namespace fold
+
+using fold::foldt_state;
+using fold::fold_stream;
+
+} // namespace falcon
+
+#endif
@@ -0,0 +1,22 @@
+#include <falcon/fold/instantiations.hpp>
+
+namespace falcon {
+namespace fold {
+namespace precompiled {
+
+// the explicit template argument excludes the non-template overloads
+#define FALCON_FOLD_INSTANTIATIONS_DEFINE(name, R, P, n)          \
+  R name(std::plus<> f, FALCON_FOLD_INSTANTIATIONS_PARAMS_##n(P)) \
+  {                                                               \
+    return ::falcon::fold::name<std::plus<>&>(                    \
+      f, FALCON_FOLD_INSTANTIATIONS_ARGS_##n                      \
+    );                                                            \
+  }
+
+FALCON_FOLD_INSTANTIATIONS(FALCON_FOLD_INSTANTIATIONS_DEFINE)
+
+#undef FALCON_FOLD_INSTANTIATIONS_DEFINE
+
+} // namespace precompiled
+} // namespace fold
+} // namespace falcon
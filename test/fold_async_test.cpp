@@ -0,0 +1,288 @@
+#include <falcon/fold/async.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+
+struct MkStr
+{
+  std::vector<std::string> * log;
+
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    std::string ret = "(" + x + "+" + y + ")";
+    log->push_back(ret);
+    return ret;
+  }
+};
+
+/// completed when the test calls complete(i)
+struct ManualExecutor
+{
+  std::vector<std::function<void()>> pending;
+
+  void complete(std::size_t i) {
+    auto fn = std::move(pending[i]);
+    fn();
+  }
+};
+
+struct ManualOp
+{
+  using value_type = std::string;
+
+  ManualExecutor * ex;
+  std::size_t id;
+  std::string value;
+
+  template<class Cb>
+  void operator()(Cb cb) {
+    if (ex->pending.size() <= id) {
+      ex->pending.resize(id + 1);
+    }
+    std::string v = value;
+    ex->pending[id] = [cb, v]() mutable { cb(std::move(v)); };
+  }
+};
+
+struct ManualIntOp
+{
+  using value_type = int;
+
+  ManualExecutor * ex;
+  std::size_t id;
+  int value;
+
+  template<class Cb>
+  void operator()(Cb cb) {
+    if (ex->pending.size() <= id) {
+      ex->pending.resize(id + 1);
+    }
+    int v = value;
+    ex->pending[id] = [cb, v]() mutable { cb(v); };
+  }
+};
+
+struct CountPlus
+{
+  int * calls;
+
+  int operator()(int x, int y) const {
+    ++*calls;
+    return x + y;
+  }
+};
+
+#if FALCON_FOLD_ASYNC_COROUTINE
+struct ManualAwaitable
+{
+  ManualExecutor * ex;
+  std::size_t id;
+  std::string value;
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> h) {
+    if (ex->pending.size() <= id) {
+      ex->pending.resize(id + 1);
+    }
+    ex->pending[id] = [h]() { h.resume(); };
+  }
+
+  std::string await_resume() { return value; }
+};
+
+struct Detached
+{
+  struct promise_type
+  {
+    Detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+template<class Aw>
+Detached await_into(Aw aw, std::string & out) {
+  out = co_await std::move(aw);
+}
+#endif
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  std::vector<std::string> log;
+  MkStr f{&log};
+  std::string result;
+  auto set_result = [&result](std::string s) { result = std::move(s); };
+
+  {
+    ManualExecutor ex;
+    auto op = async_foldt(
+      f,
+      ManualOp{&ex, 0, "1"}, ManualOp{&ex, 1, "2"}, ManualOp{&ex, 2, "3"},
+      ManualOp{&ex, 3, "4"}, ManualOp{&ex, 4, "5"}
+    );
+    op(set_result);
+    CHECK(5u, ex.pending.size());
+
+    // sub-trees are combined as soon as both children are completed
+    ex.complete(3);
+    ex.complete(4);
+    CHECK(0u, log.size());
+    ex.complete(2);
+    CHECK(1u, log.size());
+    CHECK("(3+4)", log.back());
+    ex.complete(0);
+    CHECK(1u, log.size());
+    ex.complete(1);
+    CHECK(4u, log.size());
+    CHECK("((1+2)+(3+4))", log[2]);
+    CHECK("(((1+2)+(3+4))+5)", log[3]);
+    CHECK("(((1+2)+(3+4))+5)", result);
+  }
+
+  {
+    ManualExecutor ex;
+    result.clear();
+    auto op = async_foldbl(
+      f, ManualOp{&ex, 0, "1"}, ManualOp{&ex, 1, "2"}, ManualOp{&ex, 2, "3"}
+    );
+    op(set_result);
+    ex.complete(2);
+    ex.complete(1);
+    CHECK("", result);
+    ex.complete(0);
+    CHECK("((1+2)+3)", result);
+  }
+
+  {
+    ManualExecutor ex;
+    async_foldt(f, ManualOp{&ex, 0, "1"})(set_result);
+    ex.complete(0);
+    CHECK("1", result);
+
+    async_foldt(f)(set_result);
+    CHECK("empty", result);
+
+    async_fold<foldr_tag>(
+      f, async_ready<std::string>{"1"}, async_ready<std::string>{"2"},
+      async_ready<std::string>{"3"}
+    )(set_result);
+    CHECK("(1+(2+3))", result);
+  }
+
+  // fold_as_ready: combined in completion order
+  {
+    ManualExecutor ex;
+    result.clear();
+    log.clear();
+    auto op = fold_as_ready(
+      f, ManualOp{&ex, 0, "1"}, ManualOp{&ex, 1, "2"}, ManualOp{&ex, 2, "3"},
+      ManualOp{&ex, 3, "4"}
+    );
+    op(set_result);
+    ex.complete(2);
+    CHECK(0u, log.size());
+    ex.complete(0);
+    CHECK(1u, log.size());
+    CHECK("(3+1)", log.back());
+    ex.complete(3);
+    CHECK("((3+1)+4)", log.back());
+    CHECK("", result);
+    ex.complete(1);
+    CHECK("(((3+1)+4)+2)", result);
+
+    fold_as_ready(f, ManualOp{&ex, 0, "1"})(set_result);
+    ex.complete(0);
+    CHECK("1", result);
+
+    fold_as_ready(f)(set_result);
+    CHECK("empty", result);
+  }
+
+  // the last completion is followed by 1 combine instead of log2(n)
+  {
+    int calls = 0;
+    int sum = 0;
+    auto set_sum = [&sum](int x) { sum = x; };
+    ManualExecutor ex1;
+    ManualExecutor ex2;
+    auto op1 = fold_as_ready(
+      CountPlus{&calls},
+      ManualIntOp{&ex1, 0, 1}, ManualIntOp{&ex1, 1, 2}, ManualIntOp{&ex1, 2, 3},
+      ManualIntOp{&ex1, 3, 4}, ManualIntOp{&ex1, 4, 5}, ManualIntOp{&ex1, 5, 6},
+      ManualIntOp{&ex1, 6, 7}, ManualIntOp{&ex1, 7, 8}
+    );
+    auto op2 = async_foldt(
+      CountPlus{&calls},
+      ManualIntOp{&ex2, 0, 1}, ManualIntOp{&ex2, 1, 2}, ManualIntOp{&ex2, 2, 3},
+      ManualIntOp{&ex2, 3, 4}, ManualIntOp{&ex2, 4, 5}, ManualIntOp{&ex2, 5, 6},
+      ManualIntOp{&ex2, 6, 7}, ManualIntOp{&ex2, 7, 8}
+    );
+
+    op1(set_sum);
+    for (std::size_t i = 1; i < 8; ++i) {
+      ex1.complete(i);
+    }
+    CHECK(6, calls);
+    ex1.complete(0);
+    CHECK(7, calls);
+    CHECK(36, sum);
+
+    calls = 0;
+    op2(set_sum);
+    for (std::size_t i = 1; i < 8; ++i) {
+      ex2.complete(i);
+    }
+    CHECK(4, calls);
+    ex2.complete(0);
+    CHECK(7, calls);
+    CHECK(36, sum);
+  }
+
+#if FALCON_FOLD_ASYNC_COROUTINE
+  {
+    ManualExecutor ex;
+    result.clear();
+    await_into(
+      async_foldt(
+        f,
+        ManualAwaitable{&ex, 0, "1"}, ManualAwaitable{&ex, 1, "2"},
+        ManualAwaitable{&ex, 2, "3"}, ManualOp{&ex, 3, "4"}
+      ),
+      result
+    );
+    CHECK(4u, ex.pending.size());
+    ex.complete(1);
+    ex.complete(3);
+    ex.complete(2);
+    CHECK("", result);
+    ex.complete(0);
+    CHECK("((1+2)+(3+4))", result);
+
+    // completed before the co_await
+    await_into(async_foldt(f, async_ready<std::string>{"a"}, async_ready<std::string>{"b"}), result);
+    CHECK("(a+b)", result);
+  }
+#endif
+}
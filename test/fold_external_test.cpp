@@ -0,0 +1,208 @@
+#include <falcon/fold/external.hpp>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+
+struct StrSerializer
+{
+  void save(std::ostream & out, std::string const & s) const {
+    out << s.size() << '\n' << s;
+  }
+
+  std::string load(std::istream & in) const {
+    std::size_t n = 0;
+    in >> n;
+    in.get();
+    std::string s(n, '\0');
+    in.read(&s[0], static_cast<std::streamsize>(n));
+    return s;
+  }
+};
+
+// a range of 1 element is converted to the result type
+struct Char
+{
+  char c;
+
+  explicit operator std::string () const {
+    return std::string(1, c);
+  }
+};
+
+// throws on the call number `fail`
+struct MkStr
+{
+  int * calls;
+  int fail;
+
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(Char x, Char y) const {
+    return (*this)(std::string(x), std::string(y));
+  }
+
+  std::string operator()(std::string const & x, Char y) const {
+    return (*this)(x, std::string(y));
+  }
+
+  std::string operator()(Char x, std::string const & y) const {
+    return (*this)(std::string(x), y);
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    if (++*calls == fail) {
+      throw std::runtime_error("crash");
+    }
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+void write_file(std::string const & path, void const * data, std::size_t n)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(static_cast<char const *>(data), static_cast<std::streamsize>(n));
+}
+
+bool exists(std::string const & path)
+{
+  return bool(std::ifstream(path));
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  std::string const path = "fold_external_test.bin";
+  std::string const checkpoint = "fold_external_test.checkpoint";
+  std::remove(checkpoint.c_str());
+
+  std::string const s = "abcdefghijklmnopqrstuvwxyz";
+  write_file(path, s.data(), s.size());
+  auto const first = reinterpret_cast<Char const *>(s.data());
+
+  int calls = 0;
+  std::string const expected = range_foldt(MkStr{&calls, 0}, first, first + s.size());
+  int const total_calls = calls;
+
+  // without interruption
+  calls = 0;
+  CHECK(expected, external_foldt<Char>(path, 4, MkStr{&calls, 0}, StrSerializer{}, checkpoint));
+  CHECK(total_calls, calls);
+  CHECK(false, exists(checkpoint));
+
+  // interrupted in the 3rd chunk (3 calls per chunk of 4), then resumed
+  calls = 0;
+  std::string what;
+  try {
+    external_foldt<Char>(path, 4, MkStr{&calls, 8}, StrSerializer{}, checkpoint);
+  }
+  catch (std::runtime_error const & e) {
+    what = e.what();
+  }
+  CHECK("crash", what);
+  CHECK(true, exists(checkpoint));
+
+  // the 2 first chunks (and their combination) are not computed again
+  calls = 0;
+  CHECK(expected, external_foldt<Char>(path, 4, MkStr{&calls, 0}, StrSerializer{}, checkpoint));
+  CHECK(total_calls - 7, calls);
+  CHECK(false, exists(checkpoint));
+
+  // another chunk size
+  calls = 0;
+  try {
+    external_foldt<Char>(path, 8, MkStr{&calls, 10}, StrSerializer{}, checkpoint);
+  }
+  catch (std::runtime_error const &) {
+  }
+  what.clear();
+  try {
+    external_foldt<Char>(path, 4, MkStr{&calls, 0}, StrSerializer{}, checkpoint);
+  }
+  catch (std::runtime_error const & e) {
+    what = e.what();
+  }
+  CHECK(true, !what.empty());
+  calls = 0;
+  CHECK(expected, external_foldt<Char>(path, 8, MkStr{&calls, 0}, StrSerializer{}, checkpoint));
+
+  // a checkpoint every 3 chunks: interrupted in the 4th chunk, the 3 first
+  // chunks are not computed again
+  calls = 0;
+  try {
+    external_foldt<Char>(path, 4, MkStr{&calls, 14}, StrSerializer{}, checkpoint, 3);
+  }
+  catch (std::runtime_error const &) {
+  }
+  calls = 0;
+  CHECK(expected, external_foldt<Char>(path, 4, MkStr{&calls, 0}, StrSerializer{}, checkpoint, 3));
+  CHECK(total_calls - 10, calls);
+  CHECK(false, exists(checkpoint));
+
+  // checkpoint of another file
+  {
+    std::string const other = "fold_external_test_other.bin";
+    write_file(other, s.data(), s.size());
+    calls = 0;
+    try {
+      external_foldt<Char>(path, 4, MkStr{&calls, 8}, StrSerializer{}, checkpoint);
+    }
+    catch (std::runtime_error const &) {
+    }
+    CHECK(true, exists(checkpoint));
+
+    auto error = [&](std::string const & file) {
+      std::string what;
+      try {
+        calls = 0;
+        external_foldt<Char>(file, 4, MkStr{&calls, 0}, StrSerializer{}, checkpoint);
+      }
+      catch (std::runtime_error const & e) {
+        what = e.what();
+      }
+      return what;
+    };
+
+    // same size, another path
+    CHECK(true, !error(other).empty());
+    // same path, shorter
+    write_file(path, s.data(), 6);
+    CHECK(true, !error(path).empty());
+    CHECK(true, exists(checkpoint));
+
+    std::remove(other.c_str());
+    std::remove(checkpoint.c_str());
+    write_file(path, s.data(), s.size());
+  }
+
+  // trivial_serializer
+  {
+    std::vector<std::int64_t> v;
+    for (std::int64_t i = 0; i < 10000; ++i) {
+      v.push_back(i * 3);
+    }
+    write_file(path, v.data(), v.size() * sizeof(v[0]));
+    CHECK(std::int64_t{3} * 9999 * 10000 / 2, external_foldt<std::int64_t>(
+      path, 100, std::plus<>{}, trivial_serializer<std::int64_t>{}, checkpoint));
+  }
+
+  std::remove(path.c_str());
+}
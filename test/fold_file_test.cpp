@@ -0,0 +1,170 @@
+#include <falcon/fold/file.hpp>
+
+#include <string>
+#include <vector>
+#include <numeric>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+// a range of 1 element is converted to the result type
+struct Record
+{
+  std::uint32_t key;
+  std::uint32_t value;
+
+  explicit operator std::uint64_t () const {
+    return value;
+  }
+};
+
+struct Char
+{
+  char c;
+
+  explicit operator std::string () const {
+    return std::string(1, c);
+  }
+};
+
+struct MkStr
+{
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(Char x, Char y) const {
+    return (*this)(std::string(x), std::string(y));
+  }
+
+  std::string operator()(std::string const & x, Char y) const {
+    return (*this)(x, std::string(y));
+  }
+
+  std::string operator()(Char x, std::string const & y) const {
+    return (*this)(std::string(x), y);
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+struct SumValues
+{
+  std::uint64_t operator()(Record const & x, Record const & y) const {
+    return std::uint64_t{x.value} + y.value;
+  }
+
+  std::uint64_t operator()(std::uint64_t x, Record const & y) const {
+    return x + y.value;
+  }
+
+  std::uint64_t operator()(Record const & x, std::uint64_t y) const {
+    return x.value + y;
+  }
+
+  std::uint64_t operator()(std::uint64_t x, std::uint64_t y) const {
+    return x + y;
+  }
+};
+
+void write_file(std::string const & path, void const * data, std::size_t n)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(static_cast<char const *>(data), static_cast<std::streamsize>(n));
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  std::string const path = "fold_file_test.bin";
+
+  write_file(path, "12345", 5);
+  CHECK("((((1+2)+3)+4)+5)", fold_file<Char>(path, MkStr{}));
+  CHECK("(((1+2)+(3+4))+5)", fold_file<Char>(path, MkStr{}, foldt_tag{}));
+  CHECK("((1+2)+(3+(4+5)))", fold_file<Char>(path, MkStr{}, foldbr_tag{}));
+  CHECK("(((1+2)+3)+(4+5))", fold_file<Char>(path, MkStr{}, foldbl_tag{}));
+
+  {
+    mapped_file const file(path);
+    CHECK(5u, file.size());
+    CHECK('1', file.data()[0]);
+  }
+
+  write_file(path, "", 0);
+  CHECK("empty", fold_file<Char>(path, MkStr{}));
+
+  {
+    std::vector<Record> records(100000);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+      records[i] = {std::uint32_t(i), std::uint32_t(i * 3)};
+    }
+    write_file(path, records.data(), records.size() * sizeof(Record));
+    std::uint64_t const sum = std::uint64_t{3} * 99999 * 100000 / 2;
+    CHECK(sum, (fold_file<Record>(path, SumValues{})));
+    CHECK(sum, (fold_file<Record>(path, SumValues{}, foldt_tag{})));
+
+    thread_pool pool(4);
+    CHECK(sum, (par_fold_file<Record, 1024>(pool, path, SumValues{})));
+
+    std::vector<std::uint32_t> values(4097);
+    std::iota(values.begin(), values.end(), 1u);
+    write_file(path, values.data(), values.size() * sizeof(std::uint32_t));
+    CHECK(4097u * 4098u / 2, (par_fold_file<std::uint32_t, 64>(pool, path, std::plus<>{})));
+  }
+
+  // several chunks of 4 MiB: same order as the range versions
+  {
+    std::vector<float> floats(1500000);
+    for (std::size_t i = 0; i < floats.size(); ++i) {
+      floats[i] = 1.f / float(i % 97 + 1);
+    }
+    write_file(path, floats.data(), floats.size() * sizeof(float));
+    float const * p = floats.data();
+    float const l = range_foldl(std::plus<>{}, p, p + floats.size());
+    float const t = range_foldt(std::plus<>{}, p, p + floats.size());
+    float const fl = fold_file<float>(path, std::plus<>{});
+    float const ft = fold_file<float>(path, std::plus<>{}, foldt_tag{});
+    CHECK(true, std::memcmp(&l, &fl, sizeof(l)) == 0);
+    CHECK(true, std::memcmp(&t, &ft, sizeof(t)) == 0);
+  }
+
+  // errors
+  {
+    write_file(path, "123", 3);
+    std::string what;
+    try {
+      fold_file<std::uint16_t>(path, std::plus<>{});
+    }
+    catch (std::runtime_error const & e) {
+      what = e.what();
+    }
+    CHECK(true, !what.empty());
+
+    std::remove(path.c_str());
+    bool error = false;
+    try {
+      fold_file<Char>(path, MkStr{});
+    }
+    catch (std::system_error const &) {
+      error = true;
+    }
+    CHECK(true, error);
+  }
+}
@@ -0,0 +1,92 @@
+#include <falcon/fold/format.hpp>
+
+#include <new>
+#include <string>
+#include <cstdlib>
+
+static std::size_t allocations = 0;
+
+void * operator new(std::size_t n) {
+  ++allocations;
+  if (void * p = std::malloc(n ? n : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept {
+  std::free(p);
+}
+
+template<class... Ts>
+std::string format(std::size_t size, Ts const & ... args) {
+  char buf[64];
+  auto const res = falcon::fold_format(buf, size, args...);
+  std::string s(buf, res.end);
+  s += '|';
+  s += std::to_string(res.size);
+  s += res.truncated ? "|truncated" : "";
+  return s;
+}
+
+
+#include <iostream>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  std::string const bc("bc");
+
+  CHECK("|0", format(64, ", "));
+  CHECK("a|1", format(64, ", ", "a"));
+  CHECK("a, bc, d|8", format(64, ", ", "a", bc, 'd'));
+  CHECK("a-bc-d|6", format(64, '-', "a", bc, 'd'));
+  CHECK("abcd|4", format(64, "", "a", bc, 'd'));
+
+  // truncation
+  CHECK("a, bc, d|8", format(8, ", ", "a", bc, 'd'));
+  CHECK("a, bc, |8|truncated", format(7, ", ", "a", bc, 'd'));
+  CHECK("a, b|8|truncated", format(4, ", ", "a", bc, 'd'));
+  CHECK("a,|8|truncated", format(2, ", ", "a", bc, 'd'));
+  CHECK("|8|truncated", format(0, ", ", "a", bc, 'd'));
+  CHECK(11u, falcon::fold_format(nullptr, 0, ' ', "abc", "defg", bc).size);
+
+  // empty pieces with a null data()
+  {
+    struct null_view
+    {
+      char const * data() const { return nullptr; }
+      std::size_t size() const { return 0; }
+    };
+    char const * null_str = nullptr;
+    CHECK("a--b|4", format(64, '-', "a", null_view{}, "b"));
+    CHECK("ab|2", format(64, null_view{}, "a", null_str, "b"));
+    CHECK(0u, falcon::fold_format(nullptr, 0, "", "", null_view{}, null_str).size);
+    CHECK(false, falcon::fold_format(nullptr, 0, null_view{}, null_view{}).truncated);
+  }
+
+  // without allocation
+  {
+    char buf[64];
+    std::size_t const n = allocations;
+    auto const res = falcon::fold_format(buf, sizeof(buf), ", ", "abc", bc, 'd', bc, "efg");
+    auto const res2 = falcon::fold_format(buf, 3, ", ", "abc", bc, 'd', bc, "efg");
+    CHECK(n, allocations);
+    CHECK("abc, bc, d, bc, efg", std::string(buf, res.end));
+    CHECK(false, res.truncated);
+    CHECK(true, res2.truncated);
+    CHECK(res.size, res2.size);
+  }
+}
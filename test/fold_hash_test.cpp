@@ -0,0 +1,136 @@
+#include <falcon/fold/hash.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+constexpr std::size_t nkey = 8;
+constexpr std::size_t nbit = nkey * 64;
+
+template<class Tag, std::size_t... I>
+std::uint64_t hash_key(std::uint64_t const * k, std::index_sequence<I...>) {
+  return falcon::hash_fold<Tag>(k[I]...);
+}
+
+/**
+ * Avalanche (SMHasher): flipping one bit of the input flips each bit of the
+ * output with a probability of 1/2.
+ * \return  worst bias (|probability - 1/2|) of all pairs of (input bit, output bit)
+ */
+template<class Tag>
+double avalanche_bias(unsigned ntrial) {
+  std::mt19937_64 gen(42);
+  std::vector<unsigned> flips(nbit * 64);
+  std::uint64_t k[nkey];
+  for (unsigned trial = 0; trial < ntrial; ++trial) {
+    for (auto & x : k) {
+      x = gen();
+    }
+    std::uint64_t const h = hash_key<Tag>(k, std::make_index_sequence<nkey>());
+    for (std::size_t i = 0; i < nbit; ++i) {
+      k[i / 64] ^= std::uint64_t{1} << (i % 64);
+      std::uint64_t const d = h ^ hash_key<Tag>(k, std::make_index_sequence<nkey>());
+      k[i / 64] ^= std::uint64_t{1} << (i % 64);
+      for (std::size_t j = 0; j < 64; ++j) {
+        flips[i * 64 + j] += unsigned((d >> j) & 1u);
+      }
+    }
+  }
+  double bias = 0;
+  for (unsigned n : flips) {
+    double const p = double(n) / ntrial - 0.5;
+    bias = std::max(bias, p < 0 ? -p : p);
+  }
+  return bias;
+}
+
+/// Swapping 2 different leaves changes the hash
+template<class Hash>
+bool permutation_collides(Hash hash) {
+  std::uint64_t k[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::uint64_t const h = hash(k);
+  for (std::size_t i = 0; i < 8; ++i)
+  for (std::size_t j = i + 1; j < 8; ++j) {
+    std::swap(k[i], k[j]);
+    bool const same = hash(k) == h;
+    std::swap(k[i], k[j]);
+    if (same) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template<class Tag>
+bool permutation_collides() {
+  return permutation_collides([](std::uint64_t const * k) {
+    return hash_key<Tag>(k, std::make_index_sequence<nkey>());
+  });
+}
+
+/// Keys of 4 small values (sparse keys): no collision
+template<class Tag>
+bool sparse_keys_collide() {
+  std::vector<std::uint64_t> v;
+  for (unsigned a = 0; a < 16; ++a)
+  for (unsigned b = 0; b < 16; ++b)
+  for (unsigned c = 0; c < 16; ++c)
+  for (unsigned d = 0; d < 16; ++d) {
+    v.push_back(falcon::hash_fold<Tag>(a, b, c, d));
+  }
+  std::sort(v.begin(), v.end());
+  return std::adjacent_find(v.begin(), v.end()) != v.end();
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+  using ops::hash_combine;
+
+  static_assert(hash_combine{}(1, 2) != hash_combine{}(2, 1), "");
+  static_assert(hash_combine::mix(0) != 0, "");
+
+  std::hash<int> const h{};
+  hash_combine const c{};
+  CHECK(hash_combine::mix(0), hash_fold());
+  CHECK(hash_combine::mix(h(1)), hash_fold(1));
+  CHECK(hash_combine::mix(c(c(c(h(1), h(2)), c(h(3), h(4))), h(5))), hash_fold(1, 2, 3, 4, 5));
+  CHECK(hash_combine::mix(c(c(c(c(h(1), h(2)), h(3)), h(4)), h(5))), hash_fold<foldl_tag>(1, 2, 3, 4, 5));
+  CHECK(true, hash_fold(1, 2) != hash_fold(2, 1));
+  CHECK(true, hash_fold(1, std::string("a"), 2.5) != hash_fold(1, std::string("b"), 2.5));
+  CHECK(hash_fold(1, std::string("a"), 2.5), hash_fold(1, std::string("a"), 2.5));
+
+  CHECK(true, hash_fold<foldr_tag>(1, 2, 3) != hash_fold<foldr_tag>(2, 1, 3));
+  CHECK(false, permutation_collides<foldt_tag>());
+  CHECK(false, permutation_collides<foldl_tag>());
+  CHECK(false, permutation_collides<foldr_tag>());
+  CHECK(false, permutation_collides<foldbl_tag>());
+  CHECK(false, permutation_collides<foldbr_tag>());
+  CHECK(false, permutation_collides([&](std::uint64_t const * k) {
+    auto const folder = [&](auto... xs) { return foldt(c, xs...); };
+    return hash_combine::mix(foldp(folder, c, k[0], k[1], k[2], k[3], k[4], k[5], k[6], k[7]));
+  }));
+
+  CHECK(false, sparse_keys_collide<foldt_tag>());
+  CHECK(false, sparse_keys_collide<foldl_tag>());
+
+  // 2000 trials: standard deviation of 0.011, worst of 32768 pairs near 0.047
+  // with a perfect hash
+  CHECK(true, avalanche_bias<foldt_tag>(2000) < 0.06);
+  CHECK(true, avalanche_bias<foldl_tag>(2000) < 0.06);
+  CHECK(true, avalanche_bias<foldr_tag>(2000) < 0.06);
+}
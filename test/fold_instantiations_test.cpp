@@ -0,0 +1,112 @@
+#include <falcon/fold/instantiations.hpp>
+
+#include <string>
+#include <utility>
+
+namespace precompiled = falcon::fold::precompiled;
+
+template<class T>
+T value(std::size_t i);
+
+template<>
+int value<int>(std::size_t i) { return int(i * 7 + 1); }
+
+template<>
+long value<long>(std::size_t i) { return long(i) * 1000000007L; }
+
+// order sensitive: the shape must be the same as the template
+template<>
+double value<double>(std::size_t i) { return i % 3 ? 1e16 / double(i + 1) : 0.1 * double(i); }
+
+template<>
+std::string value<std::string>(std::size_t i) { return std::string(1, char('a' + i)); }
+
+// without -Wfloat-equal
+template<class T>
+bool same(T const & x, T const & y)
+{
+  return !(x < y) && !(y < x);
+}
+
+template<class T, std::size_t... Ints>
+bool check_arity(std::index_sequence<Ints...>)
+{
+  T const xs[] {value<T>(Ints)...};
+  std::plus<> plus;
+  // explicit template argument: function template only
+  return same(precompiled::foldl(plus, xs[Ints]...), falcon::fold::foldl<std::plus<>&>(plus, xs[Ints]...));
+}
+
+template<class T, std::size_t... Ints>
+bool check_shapes(std::index_sequence<Ints...>)
+{
+  T const xs[] {value<T>(Ints)...};
+  std::plus<> plus;
+  return check_arity<T>(std::index_sequence<Ints...>{})
+      && same(precompiled::foldr(plus, xs[Ints]...), falcon::fold::foldr<std::plus<>&>(plus, xs[Ints]...))
+      && same(precompiled::foldt(plus, xs[Ints]...), falcon::fold::foldt<std::plus<>&>(plus, xs[Ints]...));
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_ARITY(n)                                                         \
+  CHECK(true, check_shapes<int>(std::make_index_sequence<n>{}));               \
+  CHECK(true, check_shapes<long>(std::make_index_sequence<n>{}));              \
+  CHECK(true, check_shapes<double>(std::make_index_sequence<n>{}));            \
+  CHECK(true, check_arity<std::string>(std::make_index_sequence<n>{}))
+
+  CHECK_ARITY(4);
+  CHECK_ARITY(5);
+  CHECK_ARITY(6);
+  CHECK_ARITY(7);
+  CHECK_ARITY(8);
+  CHECK_ARITY(9);
+  CHECK_ARITY(10);
+  CHECK_ARITY(11);
+  CHECK_ARITY(12);
+  CHECK_ARITY(13);
+  CHECK_ARITY(14);
+  CHECK_ARITY(15);
+  CHECK_ARITY(16);
+
+  // the non-template overloads exist with these signatures
+  int (*foldl4)(std::plus<>, int, int, int, int) = &precompiled::foldl;
+  double (*foldt16)(
+    std::plus<>, double, double, double, double, double, double, double, double,
+    double, double, double, double, double, double, double, double
+  ) = &precompiled::foldt;
+  std::string (*concat4)(
+    std::plus<>, std::string const &, std::string const &,
+    std::string const &, std::string const &
+  ) = &precompiled::foldl;
+
+  CHECK(10, foldl4(std::plus<>{}, 1, 2, 3, 4));
+  CHECK(136, int(foldt16(std::plus<>{}, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16)));
+  CHECK("abcd", concat4(std::plus<>{}, "a", "b", "c", "d"));
+
+  // other signatures use the templates
+  CHECK(6, precompiled::foldl(std::plus<>{}, 1, 2, 3));
+  CHECK(6u, precompiled::foldt(std::plus<>{}, 1u, 2u, 3u, 0u));
+
+  // falcon::foldl and falcon::fold::foldl are still the constexpr templates
+  static_assert(falcon::foldl(std::plus<>{}, 1, 2, 3) == 6, "");
+  static_assert(falcon::foldl(std::plus<>{}, 1, 2, 3, 4) == 10, "");
+  static_assert(falcon::fold::foldt(std::plus<>{}, 1, 2, 3, 4) == 10, "");
+  {
+    using namespace falcon::fold::precompiled;
+    CHECK(10, foldr(std::plus<>{}, 1, 2, 3, 4));
+  }
+}
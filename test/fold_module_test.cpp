@@ -0,0 +1,57 @@
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+import falcon.fold;
+
+struct MkStr
+{
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+struct CMinus
+{
+  template<class T, class U>
+  constexpr auto operator()(T x, U y) const {
+    return x - y;
+  }
+};
+
+template<int i>
+struct ic
+{
+  static constexpr int value = i;
+  constexpr operator int () const { return i; }
+};
+
+int main()
+{
+  MkStr f;
+
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using std::string;
+
+  CHECK("(((1+2)+(3+4))+5)", falcon::foldt(f, string("1"), string("2"), string("3"), string("4"), string("5")));
+  CHECK("((((1+2)+3)+4)+5)", falcon::fold::foldl(f, string("1"), string("2"), string("3"), string("4"), string("5")));
+  CHECK("(1+(2+3))", falcon::fold::foldr(f, string("1"), string("2"), string("3")));
+  CHECK("empty", falcon::foldbl(f));
+  CHECK("(1+(2+3))", falcon::fold::transform_fold<falcon::fold::foldr_tag>(
+    [](int i) { return std::to_string(i); }, f, 1, 2, 3));
+
+  static_assert(falcon::fold::foldt_c<CMinus, ic<1>, ic<2>, ic<3>, ic<4>, ic<5>> == -5);
+  static_assert(falcon::fold::fold_v<falcon::fold::foldl_tag, CMinus, 1, 2, 3> == -4);
+}
@@ -0,0 +1,94 @@
+#include <falcon/fold/numa.hpp>
+
+#include <string>
+#include <vector>
+#include <numeric>
+
+struct MkStr
+{
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  CHECK(9u, falcon::detail::fold::parse_cpulist("0-3,8,10-13\n").size());
+  CHECK(13u, falcon::detail::fold::parse_cpulist("0-3,8,10-13\n").back());
+  CHECK(0u, falcon::detail::fold::parse_cpulist("").size());
+
+  // the machine topology, or 1 node
+  {
+    std::vector<numa_node> const nodes = numa_nodes();
+    CHECK(true, !nodes.empty());
+    numa_pool pool;
+    CHECK(nodes.size(), pool.size());
+
+    std::vector<long> v(100000);
+    pool.for_each_part(v.begin(), v.end(), [](std::size_t, auto first, auto last) {
+      for (; first != last; ++first) {
+        *first = 3;
+      }
+    });
+    CHECK(300000, par_range_foldt(pool, std::plus<>{}, v.begin(), v.end()));
+  }
+
+  // 3 nodes without affinity
+  {
+    numa_pool pool({{0, {}}, {1, {}}, {2, {}}}, 2);
+    CHECK(3u, pool.size());
+
+    std::vector<int> v(1000);
+    std::vector<int> parts(3);
+    pool.for_each_part(v.begin(), v.end(), [&](std::size_t i, auto first, auto last) {
+      std::iota(first, last, int(first - v.begin()));
+      parts[i] = int(last - first);
+    });
+    CHECK(333, parts[0]);
+    CHECK(333, parts[1]);
+    CHECK(334, parts[2]);
+    CHECK(999, v.back());
+
+    for (int n = 0; n <= 1000; n += 7) {
+      CHECK(std::accumulate(v.begin(), v.begin() + n, 0), par_range_foldt<8>(pool, std::plus<>{}, v.begin(), v.begin() + n));
+    }
+
+    // parts of 2, 2 and 3 elements, then foldt of the 3 partial results
+    std::vector<std::string> s{"1", "2", "3", "4", "5", "6", "7"};
+    CHECK("(((1+2)+(3+4))+((5+6)+7))", par_range_foldt<2>(pool, MkStr{}, s.begin(), s.end()));
+    CHECK("(1+2)", par_range_foldt(pool, MkStr{}, s.begin(), s.begin() + 2));
+    CHECK("empty", par_range_foldt(pool, MkStr{}, s.begin(), s.begin()));
+
+    std::string what;
+    try {
+      pool.for_each_part(v.begin(), v.end(), [](std::size_t i, auto, auto) {
+        if (i == 1) {
+          throw std::runtime_error("1");
+        }
+      });
+    }
+    catch (std::runtime_error const & e) {
+      what = e.what();
+    }
+    CHECK("1", what);
+  }
+}
@@ -0,0 +1,107 @@
+#include <falcon/fold/ops.hpp>
+
+#include <vector>
+#include <cstring>
+
+template<class T>
+bool same_bits(T x, T y) {
+  return std::memcmp(&x, &y, sizeof(T)) == 0;
+}
+
+template<class T>
+bool same_bits(falcon::fold::ops::kahan_accumulator<T> const & x,
+               falcon::fold::ops::kahan_accumulator<T> const & y) {
+  return same_bits(x.sum, y.sum) && same_bits(x.compensation, y.compensation);
+}
+
+/// large and small values, with cancellations
+template<class T>
+std::vector<T> make_values(std::size_t n, T step) {
+  std::vector<T> v;
+  T x = step;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(i % 3 ? x : -x * T(1000));
+    x = x * T(3) + step;
+    if (x > T(1000000)) {
+      x = step / T(7);
+    }
+  }
+  return v;
+}
+
+template<class T>
+T abs_diff(T x, T y) {
+  return x < y ? y - x : x - y;
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+// range_foldt with the SIMD leaves (pointers) and without (vector iterators)
+#define CHECK_SIMD(T, step)                                                    \
+  do {                                                                         \
+    auto const v = make_values<T>(100, step);                                  \
+    for (std::size_t n = 0; n <= v.size(); ++n) {                              \
+      auto const x = range_foldt(kahan_plus{}, v.data(), v.data() + n);        \
+      auto const y = range_foldt(kahan_plus{}, v.begin(), v.begin() + int(n)); \
+      if (!same_bits(x, y)) {                                                  \
+        std::cerr << __LINE__ << ": " #T " n=" << n << "\n"                    \
+          << x.sum << " " << x.compensation << " != "                          \
+          << y.sum << " " << y.compensation << std::endl;                      \
+        std::abort();                                                          \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+  using ops::kahan_plus;
+  using ops::kahan_accumulator;
+
+  // the rounding errors are kept with all the shapes
+  CHECK(0, int(foldl(std::plus<>{}, 1., 1e100, 1., -1e100)));
+  CHECK(2, int(foldl(kahan_plus{}, 1., 1e100, 1., -1e100).value()));
+  CHECK(2, int(foldr(kahan_plus{}, 1., 1e100, 1., -1e100).value()));
+  CHECK(2, int(foldt(kahan_plus{}, 1., 1e100, 1., -1e100).value()));
+  CHECK(2, int(foldbl(kahan_plus{}, 1., 1e100, 1., -1e100).value()));
+  CHECK(2, int(foldbr(kahan_plus{}, 1., 1e100, 1., -1e100, 0.)));
+  CHECK(3, int(foldl(kahan_plus{}, 1.f, 1e30f, 2.f, -1e30f).value()));
+  static_assert(foldl(kahan_plus{}, 1., 1e100, 1., -1e100).value() > 1.5, "");
+
+  {
+    std::vector<double> const v{1., 1e100, 1., -1e100};
+    CHECK(2, int(range_foldl(kahan_plus{}, v.begin(), v.end()).value()));
+    CHECK(2, int(range_foldt(kahan_plus{}, v.begin(), v.end()).value()));
+    CHECK(1, int(range_foldt(kahan_plus{}, v.begin(), v.begin() + 1).value()));
+    CHECK(0, int(range_foldl(kahan_plus{}, v.begin(), v.begin()).value()));
+
+    std::vector<kahan_accumulator<double>> out(v.size());
+    range_scanl(kahan_plus{}, v.begin(), v.end(), out.begin());
+    CHECK(1, int(out[0].value()));
+    CHECK(2, int(out[3].value()));
+  }
+
+  // long chains
+  {
+    std::vector<float> const v(100000, 0.1f);
+    float const plain = range_foldl(std::plus<>{}, v.begin(), v.end());
+    float const kahan = range_foldl(kahan_plus{}, v.begin(), v.end());
+    CHECK(true, abs_diff(kahan, 10000.f) < 0.01f);
+    CHECK(true, abs_diff(plain, 10000.f) > 1.f);
+  }
+
+  // SIMD leaves have the same result as the scalar version
+  CHECK_SIMD(float, 0.1f);
+  CHECK_SIMD(double, 0.1);
+}
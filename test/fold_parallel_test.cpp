@@ -0,0 +1,216 @@
+#include <falcon/fold/parallel.hpp>
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <cstring>
+
+struct MkStr
+{
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+/// calls of fn in progress at the same time
+struct SlowPlus
+{
+  std::atomic<int> * active;
+  std::atomic<int> * peak;
+
+  int operator()(int x, int y) const {
+    int const n = ++*active;
+    int p = *peak;
+    while (p < n && !peak->compare_exchange_weak(p, n)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    --*active;
+    return x + y;
+  }
+};
+
+struct ThrowPlus
+{
+  int operator()(int x, int y) const {
+    if (x == 3) {
+      throw std::runtime_error("3");
+    }
+    return x + y;
+  }
+};
+
+/// runs the tasks in post()
+struct InlineExecutor
+{
+  int posted = 0;
+
+  template<class F>
+  void post(F f) {
+    ++posted;
+    f();
+  }
+};
+
+/// never runs the tasks
+struct NullExecutor
+{
+  std::vector<std::function<void()>> tasks;
+
+  void post(std::function<void()> f) {
+    tasks.push_back(std::move(f));
+  }
+};
+
+template<std::size_t I>
+using str = std::string;
+
+template<class Ex, std::size_t... I>
+bool same_as_foldt(Ex & ex, std::index_sequence<I...>) {
+  return falcon::foldt(MkStr{}, str<I>(std::to_string(I))...)
+      == falcon::par_foldt(ex, MkStr{}, str<I>(std::to_string(I))...);
+}
+
+template<class Ex, std::size_t... N>
+std::string check_foldt(Ex & ex, std::index_sequence<N...>) {
+  std::string s;
+  (void)std::initializer_list<int>{
+    (s += same_as_foldt(ex, std::make_index_sequence<N>()) ? "" : std::to_string(N) + " ", 0)...
+  };
+  return s;
+}
+
+template<class Ex>
+int max_concurrency(Ex & ex) {
+  std::atomic<int> active {0};
+  std::atomic<int> peak {0};
+  int const sum = falcon::par_foldt(
+    ex, SlowPlus{&active, &peak},
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+  );
+  return sum == 136 ? peak.load() : -1;
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  MkStr f;
+  thread_pool pool(8);
+  CHECK(8u, pool.size());
+
+  CHECK("empty", par_foldt(pool, f));
+  CHECK("1", par_foldt(pool, f, std::string("1")));
+  CHECK("(1+2)", par_foldt(pool, f, std::string("1"), std::string("2")));
+  CHECK("(((1+2)+(3+4))+5)", par_foldt(pool, f,
+    std::string("1"), std::string("2"), std::string("3"), std::string("4"), std::string("5")));
+  CHECK("(1+(2+(3+4)))", par_fold<foldr_tag>(pool, f,
+    std::string("1"), std::string("2"), std::string("3"), std::string("4")));
+  CHECK("(((1+2)+3)+(4+5))", par_fold<foldbl_tag>(pool, f,
+    std::string("1"), std::string("2"), std::string("3"), std::string("4"), std::string("5")));
+
+  {
+    std::string const a("a");
+    std::string b("b");
+    CHECK("((a+b)+c)", par_foldt(pool, f, a, b, std::string("c")));
+  }
+
+  std::make_index_sequence<34> const sizes{};
+  CHECK("", check_foldt(pool, sizes));
+
+  // sub-trees not started are computed by the waiting thread
+  {
+    thread_pool pool1(1);
+    InlineExecutor inline_ex;
+    NullExecutor null_ex;
+    CHECK("", check_foldt(pool1, sizes));
+    CHECK("", check_foldt(inline_ex, sizes));
+    CHECK("", check_foldt(null_ex, sizes));
+    inline_ex.posted = 0;
+    CHECK(1, max_concurrency(inline_ex));
+    CHECK(7, inline_ex.posted);
+    CHECK(1, max_concurrency(null_ex));
+  }
+
+  // the first level (8 calls) runs on 8 threads
+  CHECK(8, max_concurrency(pool));
+
+  // ranges
+  {
+    std::vector<std::string> v;
+    for (int i = 0; i < 100; ++i) {
+      v.push_back(std::to_string(i));
+    }
+    for (std::size_t n = 0; n <= v.size(); ++n) {
+      CHECK(range_foldt(f, v.begin(), v.begin() + int(n)), par_range_foldt<4>(pool, f, v.begin(), v.begin() + int(n)));
+      CHECK(range_foldt(f, v.begin(), v.begin() + int(n)), par_range_foldt<1>(pool, f, v.begin(), v.begin() + int(n)));
+    }
+    CHECK(range_foldt(f, v.begin(), v.end()), par_range_foldt(pool, f, v.begin(), v.end()));
+
+    std::vector<float> floats;
+    for (int i = 0; i < 100000; ++i) {
+      floats.push_back(1.f / float(i % 97 + 1));
+    }
+    float const * p = floats.data();
+    float const x = range_foldt(std::plus<>{}, p, p + floats.size());
+    float const y = par_range_foldt<1024>(pool, std::plus<>{}, p, p + floats.size());
+    CHECK(true, std::memcmp(&x, &y, sizeof(x)) == 0);
+  }
+
+  // scans
+  {
+    std::vector<std::string> v;
+    for (int i = 0; i < 100; ++i) {
+      v.push_back(std::to_string(i));
+    }
+    for (std::size_t n = 0; n <= v.size(); ++n) {
+      std::vector<std::string> a(n), b(n), c(n);
+      range_scanl(std::plus<>{}, v.begin(), v.begin() + int(n), a.begin());
+      CHECK(int(n), par_range_scant<4>(pool, std::plus<>{}, v.begin(), v.begin() + int(n), b.begin()) - b.begin());
+      CHECK(true, a == b);
+      // same tree as range_scant
+      range_scant(f, v.begin(), v.begin() + int(n), a.begin());
+      par_range_scant<1>(pool, f, v.begin(), v.begin() + int(n), c.begin());
+      CHECK(true, a == c);
+    }
+
+    std::vector<long> ints(100000);
+    for (std::size_t i = 0; i < ints.size(); ++i) {
+      ints[i] = long(i % 97);
+    }
+    std::vector<long> a(ints.size()), b(ints.size());
+    range_scanl(std::plus<>{}, ints.begin(), ints.end(), a.begin());
+    par_range_scant<1024>(pool, std::plus<>{}, ints.begin(), ints.end(), b.begin());
+    CHECK(true, a == b);
+  }
+
+  // exceptions
+  {
+    std::string what;
+    try {
+      par_foldt(pool, ThrowPlus{}, 1, 2, 3, 4, 5, 6, 7, 8);
+    }
+    catch (std::runtime_error const & e) {
+      what = e.what();
+    }
+    CHECK("3", what);
+    CHECK(37, par_foldt(pool, ThrowPlus{}, 2, 2, 4, 4, 5, 6, 7, 7));
+  }
+}
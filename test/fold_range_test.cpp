@@ -0,0 +1,227 @@
+#include <falcon/fold/range.hpp>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <initializer_list>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+struct MkStr
+{
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+// same as std::plus<>, without the SIMD kernels
+struct Plus
+{
+  template<class T>
+  T operator()(T x, T y) const {
+    return x + y;
+  }
+};
+
+template<class T>
+bool same_bits(T x, T y) {
+  return std::memcmp(&x, &y, sizeof(T)) == 0;
+}
+
+template<class T>
+std::vector<T> make_values(std::size_t n, T step) {
+  std::vector<T> v;
+  T x = step;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(x);
+    x = x * T(3) + step;
+    if (x > T(1000000)) {
+      x = step / T(7);
+    }
+  }
+  return v;
+}
+
+template<std::size_t I>
+using str = std::string;
+
+/// range_foldbl and range_foldbr (with Cutoff) are the same as foldbl and foldbr
+template<std::size_t Cutoff, class It, std::size_t... I>
+bool same_as_foldb(It first, std::index_sequence<I...>) {
+  It const last = std::next(first, sizeof...(I));
+  std::vector<std::string> const v(first, last);
+  return falcon::foldbl(MkStr{}, str<I>(v[I])...) == falcon::range_foldbl<Cutoff>(MkStr{}, first, last)
+      && falcon::foldbr(MkStr{}, str<I>(v[I])...) == falcon::range_foldbr<Cutoff>(MkStr{}, first, last);
+}
+
+template<std::size_t Cutoff, class It, std::size_t... N>
+std::string check_foldb(It first, std::index_sequence<N...>) {
+  std::string s;
+  (void)std::initializer_list<int>{
+    (s += same_as_foldb<Cutoff>(first, std::make_index_sequence<N + 1>())
+      ? "" : std::to_string(N + 1) + " ", 0)...
+  };
+  return s;
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+  MkStr f;
+
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_SIMD(T, step)                                                    \
+  do {                                                                         \
+    auto const v = make_values<T>(100, step);                                  \
+    for (std::size_t n = 0; n <= v.size(); ++n) {                              \
+      T const * p = v.data();                                                  \
+      T const x = range_foldt(std::plus<>{}, p, p + n);                        \
+      T const y = range_foldt(std::plus<T>{}, p, p + n);                       \
+      T const z = range_foldt(Plus{}, p, p + n);                               \
+      if (!same_bits(x, z) || !same_bits(y, z)) {                              \
+        std::cerr << __LINE__ << ": " #T " n=" << n << "\n"                    \
+          << x << " " << y << " != " << z << std::endl;                        \
+        std::abort();                                                          \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  std::vector<std::string> v{
+    "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13"
+  };
+
+  CHECK("((((((((((((1+2)+3)+4)+5)+6)+7)+8)+9)+10)+11)+12)+13)", range_foldl(f, v.begin(), v.end()));
+  CHECK("((((1+2)+(3+4))+((5+6)+(7+8)))+(((9+10)+(11+12))+13))", range_foldt(f, v.begin(), v.end()));
+  CHECK("(((1+2)+(3+4))+5)", range_foldt(f, v.begin(), v.begin() + 5));
+
+  CHECK("(1+2)", range_foldl(f, v.begin(), v.begin() + 2));
+  CHECK("(1+2)", range_foldt(f, v.begin(), v.begin() + 2));
+
+  CHECK("1", range_foldl(f, v.begin(), v.begin() + 1));
+  CHECK("1", range_foldt(f, v.begin(), v.begin() + 1));
+
+  CHECK("empty", range_foldl(f, v.begin(), v.begin()));
+  CHECK("empty", range_foldt(f, v.begin(), v.begin()));
+
+  CHECK("(((1+2)+3)+(4+5))", range_foldbl(f, v.begin(), v.begin() + 5));
+  CHECK("((1+2)+(3+(4+5)))", range_foldbr(f, v.begin(), v.begin() + 5));
+  CHECK("(((1+2)+3)+(4+5))", range_foldbl<1>(f, v.begin(), v.begin() + 5));
+  CHECK("((1+2)+(3+(4+5)))", range_foldbr<2>(f, v.begin(), v.begin() + 5));
+  CHECK("1", range_foldbl(f, v.begin(), v.begin() + 1));
+  CHECK("empty", range_foldbl(f, v.begin(), v.begin()));
+  CHECK("empty", range_foldbr(f, v.begin(), v.begin()));
+
+  // n <= 64, recursion and unrolled leaves
+  {
+    std::vector<std::string> w;
+    for (int i = 1; i <= 64; ++i) {
+      w.push_back(std::to_string(i));
+    }
+    std::list<std::string> const l(w.begin(), w.end());
+    std::make_index_sequence<64> const sizes{};
+    CHECK("", check_foldb<1>(w.cbegin(), sizes));
+    CHECK("", check_foldb<5>(w.cbegin(), sizes));
+    CHECK("", check_foldb<16>(w.cbegin(), sizes));
+    CHECK("", check_foldb<64>(w.cbegin(), sizes));
+    CHECK("", check_foldb<7>(l.begin(), sizes));
+  }
+
+  {
+    auto folder = [&f](auto first, auto last) { return range_foldt(f, first, last); };
+    CHECK("(1+((2+3)+(((4+5)+(6+7))+(((8+9)+(10+11))+(12+13)))))", range_foldp(folder, f, v.begin(), v.end()));
+    CHECK("((1+2)+((((3+4)+(5+6))+((7+8)+(9+10)))+11))", (range_foldp<4, 2>(folder, f, v.begin(), v.begin() + 11)));
+    CHECK("(1+(((2+3)+4)+(5+6)))", range_foldp<3>(folder, f, v.begin(), v.begin() + 6));
+    CHECK("((1+2)+3)", (range_foldp<2, 4>(folder, f, v.begin(), v.begin() + 3)));
+    CHECK("(1+2)", range_foldp(folder, f, v.begin(), v.begin() + 2));
+    CHECK("1", range_foldp(folder, f, v.begin(), v.begin() + 1));
+    CHECK("empty", range_foldp(folder, f, v.begin(), v.begin()));
+
+    // folder is called on the groups of 1 element, except the first element
+    auto fm = [&f](auto first, auto last) { return "{" + range_foldt(f, first, last) + "}"; };
+    CHECK("(1+({(2+3)}+{4}))", range_foldp(fm, f, v.begin(), v.begin() + 4));
+    CHECK("(1+2)", range_foldp(fm, f, v.begin(), v.begin() + 2));
+    CHECK("({(1+2)}+{3})", (range_foldp<2, 2>(fm, f, v.begin(), v.begin() + 3)));
+    CHECK("(1+({2}+{3}))", (range_foldp<1, 1>(fm, f, v.begin(), v.begin() + 3)));
+
+    // groups of 1 element: as many groups as elements, without recursion
+    std::vector<long> big(1000000, 1);
+    auto sum = [](auto first, auto last) { return range_foldl(std::plus<>{}, first, last); };
+    CHECK(1000000, (range_foldp<1, 1>(sum, std::plus<>{}, big.begin(), big.end())));
+    CHECK(1000000, (range_foldp<1, 3>(sum, std::plus<>{}, big.begin(), big.end())));
+  }
+
+  // scans
+  {
+    std::vector<std::string> out(6);
+    CHECK(5, range_scanl(f, v.begin(), v.begin() + 5, out.begin()) - out.begin());
+    CHECK("1", out[0]);
+    CHECK("(1+2)", out[1]);
+    CHECK("((((1+2)+3)+4)+5)", out[4]);
+
+    CHECK(5, range_scant(f, v.begin(), v.begin() + 5, out.begin()) - out.begin());
+    CHECK("1", out[0]);
+    CHECK("(1+2)", out[1]);
+    CHECK("((1+2)+3)", out[2]);
+    CHECK("((1+2)+(3+4))", out[3]);
+    CHECK("(((1+2)+(3+4))+5)", out[4]);
+
+    CHECK(0, range_scant(f, v.begin(), v.begin(), out.begin()) - out.begin());
+
+    int calls = 0;
+    auto plus = [&calls](int x, int y) { ++calls; return x + y; };
+    std::vector<int> const ints = make_values<int>(100, 3);
+    std::vector<int> a(ints.size());
+    std::vector<int> b(ints.size());
+    for (std::size_t n = 1; n <= ints.size(); ++n) {
+      range_scanl(plus, ints.begin(), ints.begin() + int(n), a.begin());
+      calls = 0;
+      range_scant(plus, ints.begin(), ints.begin() + int(n), b.begin());
+      CHECK(true, std::equal(a.begin(), a.begin() + int(n), b.begin()));
+      CHECK(true, calls < int(2 * n));
+      CHECK(range_foldt(plus, ints.begin(), ints.begin() + int(n)), b[n-1]);
+    }
+  }
+
+  // SIMD leaves have the same pairing order as foldt
+  CHECK_SIMD(float, 0.1f);
+  CHECK_SIMD(double, 0.1);
+  CHECK_SIMD(std::int32_t, 7);
+  CHECK_SIMD(std::int64_t, 7);
+
+  {
+    float const a[] {
+      1e8f, 1.f, -1e8f, 3.f, 0.1f, 0.2f, 0.3f, 1e-3f,
+      7.f, 1e7f, 2.5f, -1e7f, 0.7f, 1.f, 3e5f, 1e-5f,
+      42.f
+    };
+    float const expected = foldt(
+      Plus{},
+      a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+      a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15],
+      a[16]
+    );
+    float const r = range_foldt(std::plus<>{}, a, a + 17);
+    if (!same_bits(expected, r)) {
+      std::cerr << __LINE__ << ": " << expected << " != " << r << std::endl;
+      std::abort();
+    }
+  }
+}
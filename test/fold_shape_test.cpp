@@ -0,0 +1,156 @@
+#include <falcon/fold/shape.hpp>
+
+#include <string>
+#include <initializer_list>
+
+struct Str
+{
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+struct Folder
+{
+  template<class... Ts>
+  std::string operator()(Ts const & ... args) const {
+    return falcon::foldt(Str{}, args...);
+  }
+};
+
+template<class S>
+std::string to_string(std::true_type) {
+  return "x";
+}
+
+template<class S>
+std::string to_string(std::false_type) {
+  return "("
+    + to_string<typename S::left>(std::integral_constant<bool, S::left::is_leaf>())
+    + "+"
+    + to_string<typename S::right>(std::integral_constant<bool, S::right::is_leaf>())
+    + ")";
+}
+
+template<class S>
+std::string to_string() {
+  return to_string<S>(std::integral_constant<bool, S::is_leaf>());
+}
+
+template<class S>
+std::string to_widths() {
+  std::string s;
+  for (std::size_t i = 0; i <= S::depth; ++i) {
+    s += std::to_string(S::width(i)) + " ";
+  }
+  return s;
+}
+
+/// blocks of 8 elements
+struct Split8
+{
+  static constexpr std::size_t value(std::size_t n) {
+    return n > 8 ? (n - 1) / 8 * 8 : n / 2;
+  }
+};
+
+template<std::size_t I>
+using x = std::string;
+
+/// Same tree as the fold: one error message per shape and size
+template<class Tag, std::size_t... I>
+std::string check_shape(std::index_sequence<I...>) {
+  std::string const expected = falcon::fold::transform_fold<Tag>(
+    [](std::string const & s) { return s; }, Str{}, x<I>("x")...);
+  std::string const s = to_string<falcon::shape<Tag, sizeof...(I)>>();
+  return s == expected ? std::string() : s + " != " + expected + "\n";
+}
+
+template<class Tag, std::size_t... N>
+std::string check_shapes(std::index_sequence<N...>) {
+  std::string s;
+  (void)std::initializer_list<int>{
+    (s += check_shape<Tag>(std::make_index_sequence<N + 2>()), 0)...
+  };
+  return s;
+}
+
+template<std::size_t... I>
+std::string check_foldp_shape(std::index_sequence<I...>) {
+  std::string const expected = falcon::foldp(Folder{}, Str{}, x<I>("x")...);
+  std::string const s = to_string<falcon::foldp_shape<sizeof...(I)>>();
+  return s == expected ? std::string() : s + " != " + expected + "\n";
+}
+
+template<std::size_t... N>
+std::string check_foldp_shapes(std::index_sequence<N...>) {
+  std::string s;
+  (void)std::initializer_list<int>{
+    (s += check_foldp_shape(std::make_index_sequence<N + 2>()), 0)...
+  };
+  return s;
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  // ((((1+2)+(3+4))+((5+6)+(7+8)))+(((9+10)+(11+12))+13))
+  using t13 = shape<foldt_tag, 13>;
+  static_assert(t13::size == 13, "");
+  static_assert(t13::depth == 4, "");
+  static_assert(t13::calls == 12, "");
+  static_assert(t13::split == 8, "");
+  static_assert(t13::right::split == 4, "");
+  static_assert(t13::width(3) == 6, "");
+  CHECK("1 2 4 6 12 ", to_widths<t13>());
+
+  static_assert(shape<foldl_tag, 13>::depth == 12, "");
+  static_assert(shape<foldr_tag, 13>::split == 1, "");
+  static_assert(shape<foldbl_tag, 5>::split == 3, "");
+  static_assert(shape<foldbr_tag, 5>::split == 2, "");
+  static_assert(shape<foldt_tag, 5>::depth == 3, "");
+  static_assert(shape<foldt_tag, 2>::split == 1, "");
+  static_assert(shape<foldt_tag, 1>::is_leaf, "");
+  static_assert(shape<foldt_tag, 0>::size == 0, "");
+  static_assert(shape<Split8, 20>::split == 16, "");
+  static_assert(shape<Split8, 20>::depth == 5, "");
+
+  // (1+((2+3)+(((4+5)+(6+7))+(((8+9)+(10+11))+((12+13)+14)))))
+  using p14 = foldp_shape<14>;
+  static_assert(p14::depth == 6, "");
+  static_assert(p14::calls == 13, "");
+  static_assert(p14::right::split == 2, "");
+  static_assert(p14::right::right::split == 4, "");
+  static_assert(p14::right::right::right::size == 7, "");
+  static_assert(foldp_shape<14, foldl_tag>::depth == 9, "");
+
+  // ((1+2)+((((3+4)+(5+6))+((7+8)+(9+10)))+11))
+  using p11 = foldp_shape<11, foldt_tag, 4, 2>;
+  static_assert(p11::split == 2, "");
+  static_assert(p11::right::split == 8, "");
+  static_assert(p11::depth == 5, "");
+  CHECK("((x+x)+((((x+x)+(x+x))+((x+x)+(x+x)))+x))", to_string<p11>());
+
+  std::make_index_sequence<40> const sizes{};
+  CHECK("", check_shapes<foldl_tag>(sizes));
+  CHECK("", check_shapes<foldr_tag>(sizes));
+  CHECK("", check_shapes<foldbl_tag>(sizes));
+  CHECK("", check_shapes<foldbr_tag>(sizes));
+  CHECK("", check_shapes<foldt_tag>(sizes));
+  CHECK("", check_shapes<Split8>(sizes));
+  CHECK("", check_foldp_shapes(sizes));
+}
@@ -0,0 +1,181 @@
+#include <falcon/fold/stream.hpp>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+
+// a range of 1 element is converted to the result type
+struct Char
+{
+  char c;
+
+  explicit operator std::string () const {
+    return std::string(1, c);
+  }
+};
+
+struct MkStr
+{
+  std::string operator()() const {
+    return "empty";
+  }
+
+  std::string operator()(Char x, Char y) const {
+    return (*this)(std::string(x), std::string(y));
+  }
+
+  std::string operator()(std::string const & x, Char y) const {
+    return (*this)(x, std::string(y));
+  }
+
+  std::string operator()(Char x, std::string const & y) const {
+    return (*this)(std::string(x), y);
+  }
+
+  std::string operator()(std::string const & x, std::string const & y) const {
+    return "(" + x + "+" + y + ")";
+  }
+};
+
+std::string letters(std::size_t n)
+{
+  std::string s;
+  for (std::size_t i = 0; i < n; ++i) {
+    s += char('a' + i % 26);
+  }
+  return s;
+}
+
+
+#include <iostream>
+#include <cstdlib>
+
+int main()
+{
+#define CHECK(s, f)                                                            \
+  do {                                                                         \
+    auto r = (f);                                                              \
+    if (s != r) {                                                              \
+      std::cerr << __LINE__ << ":\n" << s << " != " #f "\n" << r << std::endl; \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (0)
+
+  using namespace falcon::fold;
+
+  MkStr f;
+
+  // blocks of 4, 4, 2 and 1 elements
+  {
+    foldt_state<std::string> state;
+    state.push(f, "A", 4);
+    CHECK(1u, state.subtrees().size());
+    state.push(f, "B", 4);
+    CHECK(1u, state.subtrees().size());
+    state.push(f, "C", 2);
+    state.push(f, "D", 1);
+    CHECK(3u, state.subtrees().size());
+    CHECK(11u, state.size());
+    CHECK("((A+B)+(C+D))", state.result(f));
+    CHECK(true, state.empty());
+  }
+
+  for (std::size_t n : {0, 1, 2, 3, 7, 8, 9, 31, 100}) {
+    std::string const s = letters(n);
+    auto const first = reinterpret_cast<Char const *>(s.data());
+    std::string const l = range_foldl(f, first, first + n);
+    std::string const t = range_foldt(f, first, first + n);
+    for (std::size_t chunk : {1, 2, 3, 4, 8, 16, 1000}) {
+      std::istringstream in(s);
+      CHECK(l, fold_stream<Char>(in, chunk, f));
+      in.clear();
+      in.str(s);
+      CHECK(t, fold_stream<Char>(in, chunk, f, foldt_tag{}));
+    }
+  }
+
+  // file descriptors
+  {
+    std::vector<std::int64_t> v;
+    for (std::int64_t i = 0; i < 100000; ++i) {
+      v.push_back(i * 7);
+    }
+    std::int64_t const sum = range_foldt(std::plus<>{}, v.data(), v.data() + v.size());
+
+    char const * path = "fold_stream_test.bin";
+    {
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<char const *>(v.data()),
+                 static_cast<std::streamsize>(v.size() * sizeof(v[0])));
+    }
+    int const fd = ::open(path, O_RDONLY);
+    CHECK(sum, fold_stream<std::int64_t>(fd, 4096, std::plus<>{}));
+    CHECK(sum, fold_stream<std::int64_t>(fd, 1000, std::plus<>{}, foldt_tag{}));
+    // from the current offset
+    ::lseek(fd, 16, SEEK_SET);
+    CHECK(sum - 7, fold_stream<std::int64_t>(fd, 4096, std::plus<>{}));
+    CHECK(16, ::lseek(fd, 0, SEEK_CUR));
+    ::close(fd);
+    std::remove(path);
+
+    int pipefd[2];
+    CHECK(0, ::pipe(pipefd));
+    std::thread writer([&]{
+      auto p = reinterpret_cast<char const *>(v.data());
+      std::size_t n = v.size() * sizeof(v[0]);
+      while (n) {
+        ssize_t const r = ::write(pipefd[1], p, n);
+        if (r <= 0) {
+          break;
+        }
+        p += r;
+        n -= std::size_t(r);
+      }
+      ::close(pipefd[1]);
+    });
+    CHECK(sum, fold_stream<std::int64_t>(pipefd[0], 333, std::plus<>{}, foldt_tag{}));
+    writer.join();
+    ::close(pipefd[0]);
+
+    CHECK(true, [&]{
+      try {
+        fold_stream<std::int64_t>(-1, 16, std::plus<>{});
+      }
+      catch (std::system_error const &) {
+        return true;
+      }
+      return false;
+    }());
+  }
+
+  // errors
+  {
+    std::istringstream in("abc");
+    std::string what;
+    try {
+      fold_stream<std::uint16_t>(in, 16, std::plus<>{});
+    }
+    catch (std::runtime_error const & e) {
+      what = e.what();
+    }
+    CHECK(true, !what.empty());
+
+    in.clear();
+    in.str("abcdefgh");
+    what.clear();
+    try {
+      fold_stream<Char>(in, 2, [](auto const &, auto const &) -> std::string {
+        throw std::runtime_error("fn");
+      });
+    }
+    catch (std::runtime_error const & e) {
+      what = e.what();
+    }
+    CHECK("fn", what);
+  }
+}
@@ -55,6 +55,52 @@ struct MkAccuList
   }
 };
 
+struct CMinus
+{
+  template<class T, class U>
+  constexpr auto operator()(T x, U y) const {
+    return x - y;
+  }
+};
+
+template<int i>
+using ic = std::integral_constant<int, i>;
+
+struct Mix
+{
+  template<class T, class U>
+  constexpr auto operator()(T x, U y) const {
+    return x * 31u + y;
+  }
+};
+
+/// blocks of 8 elements
+struct Split8
+{
+  static constexpr std::size_t value(std::size_t n) {
+    return n > 8 ? (n - 1) / 8 * 8 : n / 2;
+  }
+};
+
+/// largest Fibonacci number less than n
+struct Fibonacci
+{
+  static constexpr std::size_t value(std::size_t n) {
+    std::size_t a = 1, b = 2;
+    while (b < n) {
+      b += a;
+      a = b - a;
+    }
+    return a;
+  }
+};
+
+/// fold(Mix{}, 0u, 1ul, 2u, 3ul, ...)
+template<class Fold, std::size_t... I>
+unsigned long mixed_fold(Fold fold, std::index_sequence<I...>) {
+  return fold(Mix{}, std::conditional_t<I % 2, unsigned long, unsigned>(I)...);
+}
+
 
 #include <iostream>
 #include <cstdlib>
@@ -84,21 +130,50 @@ int main()
   CHECK("((((1+2)+(3+4))+((5+6)+(7+8)))+(((9+10)+(11+12))+13))", foldt(f, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13));
   CHECK("(((1+2)+(3+4))+5)", foldt(f, 1, 2, 3, 4, 5));
   CHECK("(1+((2+3)+(((4+5)+(6+7))+(((8+9)+(10+11))+((12+13)+0)))))", foldp(ff, f, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 0));
+  CHECK("((1+2)+((((3+4)+(5+6))+((7+8)+(9+10)))+11))", (foldp<4, 2>(ff, f, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11)));
+  CHECK("(1+(((2+3)+4)+(5+6)))", foldp<3>(ff, f, 1, 2, 3, 4, 5, 6));
+  CHECK("((1+2)+3)", (foldp<2, 4>(ff, f, 1, 2, 3)));
+  {
+    // folder is called on the groups of 1 element, except the first element
+    auto fm = [&f](auto const & ... x) {
+      using ::to_string;
+      using std::to_string;
+      auto const & r = foldt(f, x...);
+      return "{" + to_string(r) + "}";
+    };
+    CHECK("(1+({(2+3)}+{4}))", foldp(fm, f, 1, 2, 3, 4));
+    CHECK("(1+2)", foldp(fm, f, 1, 2));
+    CHECK("({(1+2)}+{3})", (foldp<2, 2>(fm, f, 1, 2, 3)));
+    CHECK("(1+({2}+{3}))", (foldp<1, 1>(fm, f, 1, 2, 3)));
+  }
+
+  CHECK("((((1+2)+(3+4))+((5+6)+(7+8)))+(9+10))", foldtree<Split8>(f, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+  CHECK("(((1+2)+3)+(4+5))", foldtree<Fibonacci>(f, 1, 2, 3, 4, 5));
+  CHECK("((((1+2)+3)+(4+5))+((6+7)+8))", foldtree<Fibonacci>(f, 1, 2, 3, 4, 5, 6, 7, 8));
+  CHECK("(((1+2)+(3+4))+5)", foldtree<foldt_tag>(f, 1, 2, 3, 4, 5));
+  CHECK("((1+2)+(3+(4+5)))", foldtree<foldbr_tag>(f, 1, 2, 3, 4, 5));
+  CHECK("(1+(2+(3+4)))", foldtree<foldr_tag>(f, 1, 2, 3, 4));
+  CHECK("(((1+2)+3)+4)", foldtree<foldl_tag>(f, 1, 2, 3, 4));
+  static_assert(foldtree<Split8>(CMinus{}, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10) == 1, "");
 
   CHECK("(1+2)", foldr(f, 1, 2));
+  CHECK("(((1+2)+3)+4)", foldl(f, 1, 2, 3, 4));
   CHECK("(1+2)", foldl(f, 1, 2));
   CHECK("(1+2)", foldt(f, 1, 2));
   CHECK("(1+2)", foldp(ff, f, 1, 2));
+  CHECK("(1+2)", foldtree<Split8>(f, 1, 2));
 
   CHECK(1, foldr(f, 1));
   CHECK(1, foldl(f, 1));
   CHECK(1, foldt(f, 1));
   CHECK(1, foldp(ff, f, 1));
+  CHECK(1, foldtree<Split8>(f, 1));
 
   CHECK("empty", foldr(f));
   CHECK("empty", foldl(f));
   CHECK("empty", foldt(f));
   CHECK("empty", foldp(ff, f));
+  CHECK("empty", foldtree<Split8>(f));
 
   // ref qualifier tests
   CHECK("[((0+1)+2)]", foldl(MkStr{}, 0, 1, 2));
@@ -107,6 +182,49 @@ int main()
   CHECK("[(0+(1+2))]", foldbr(MkStr{}, 0, 1, 2));
   CHECK("[((0+1)+(2+3))]", foldt(MkStr{}, 0, 1, 2, 3));
   CHECK("[(0+((1+2)+3))]", foldp(ff, MkStr{}, 0, 1, 2, 3));
+  CHECK("[((0+1)+(2+3))]", (foldp<2, 2>(ff, MkStr{}, 0, 1, 2, 3)));
+  CHECK("[(((0+1)+2)+(3+4))]", foldtree<Fibonacci>(MkStr{}, 0, 1, 2, 3, 4));
+
+  // same type and value category (runtime loop with FALCON_FOLD_OPTIMIZE_SIZE)
+  {
+    std::string const s[]{"1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13"};
+    CHECK("(1+(2+(3+(4+(5+(6+(7+(8+(9+(10+(11+(12+13))))))))))))", foldr(f, s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10], s[11], s[12]));
+    CHECK("((((((((((((1+2)+3)+4)+5)+6)+7)+8)+9)+10)+11)+12)+13)", foldl(f, s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10], s[11], s[12]));
+    CHECK("((((1+2)+(3+4))+((5+6)+7))+(((8+9)+10)+((11+12)+13)))", foldbl(f, s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10], s[11], s[12]));
+    CHECK("(((1+(2+3))+(4+(5+6)))+((7+(8+9))+((10+11)+(12+13))))", foldbr(f, s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10], s[11], s[12]));
+    CHECK("((((1+2)+(3+4))+((5+6)+(7+8)))+(((9+10)+(11+12))+13))", foldt(f, s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10], s[11], s[12]));
+    CHECK("(((1+2)+(3+4))+(5+6))", foldt(f, s[0], s[1], s[2], s[3], s[4], s[5]));
+    CHECK("((1+2)+3)", foldbl(f, s[0], s[1], s[2]));
+    CHECK("[((1+2)+(3+(4+5)))]", foldbr(MkStr{}, s[0], s[1], s[2], s[3], s[4]));
+    CHECK("[((1+2)+(3+4))]", foldt(MkStr{}, s[0], s[1], s[2], s[3]));
+    CHECK("((((1+2)+3)+(4+5))+((6+7)+8))", foldtree<Fibonacci>(f, s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]));
+    CHECK("(1+(2+3))", foldr(f, std::string("1"), std::string("2"), std::string("3")));
+    static_assert(foldbr(CMinus{}, 1, 2, 3, 4, 5) == -5, "");
+    static_assert(foldl(CMinus{}, 1, 2, 3, 4, 5, 6) == -19, "");
+  }
+
+  // from FALCON_FOLD_ERASURE_THRESHOLD arguments (runtime fold), transform_fold is the reference
+  {
+    auto id = [](auto x) { return x; };
+    using huge = std::make_index_sequence<FALCON_FOLD_ERASURE_THRESHOLD + 3>;
+#define CHECK_HUGE(name)                                                      \
+    CHECK(                                                                    \
+      mixed_fold([&](auto... x) { return transform_##name(id, x...); }, huge{}), \
+      mixed_fold([](auto... x) { return name(x...); }, huge{}))
+    CHECK_HUGE(foldl);
+    CHECK_HUGE(foldr);
+    CHECK_HUGE(foldbl);
+    CHECK_HUGE(foldbr);
+    CHECK_HUGE(foldt);
+#undef CHECK_HUGE
+    CHECK(
+      mixed_fold([&](auto... x) { return transform_fold<Split8>(id, x...); }, huge{}),
+      mixed_fold([](auto... x) { return foldtree<Split8>(x...); }, huge{}));
+    // same type: array of pointers
+    CHECK(
+      mixed_fold([](auto... x) { return foldt(x...); }, huge{}),
+      mixed_fold([](auto f, auto... x) { return foldt(f, static_cast<unsigned long>(x)...); }, huge{}));
+  }
 
   struct A {};
   struct ApplyA_rvalue { A operator()(A &&, A &&) { return {}; } };
@@ -114,6 +232,92 @@ int main()
   struct ApplyA_lvalue { A operator()(A &, A &) { return {}; } };
   {A a; foldl(ApplyA_lvalue{}, a, a);}
 
+  // transform_fold
+  auto g = [](int x) { return x * 10; };
+  CHECK("(10+(20+(30+(40+50))))", transform_foldr(g, f, 1, 2, 3, 4, 5));
+  CHECK("((((10+20)+30)+40)+50)", transform_foldl(g, f, 1, 2, 3, 4, 5));
+  CHECK("(((10+20)+30)+(40+50))", transform_foldbl(g, f, 1, 2, 3, 4, 5));
+  CHECK("((10+20)+(30+(40+50)))", transform_foldbr(g, f, 1, 2, 3, 4, 5));
+  CHECK("(((10+20)+(30+40))+50)", transform_foldt(g, f, 1, 2, 3, 4, 5));
+  CHECK("(((10+20)+(30+40))+50)", transform_fold<foldt_tag>(g, f, 1, 2, 3, 4, 5));
+  CHECK("(((10+20)+30)+(40+50))", transform_fold<Fibonacci>(g, f, 1, 2, 3, 4, 5));
+  CHECK("(10+20)", transform_foldt(g, f, 1, 2));
+  CHECK(10, transform_foldt(g, f, 1));
+  CHECK("empty", transform_foldt(g, f));
+  CHECK("[((0+10)+20)]", transform_foldl(g, MkStr{}, 0, 1, 2));
+  CHECK("[((0+10)+(20+30))]", transform_foldt(g, MkStr{}, 0, 1, 2, 3));
+  {
+    int n = 0;
+    auto count = [&n](int x) { ++n; return x; };
+    CHECK("(((1+2)+(3+4))+5)", transform_foldt(count, f, 1, 2, 3, 4, 5));
+    CHECK(5, n);
+  }
+
+  // multi_fold
+  {
+    auto min = [](int x, int y) { return x < y ? x : y; };
+    auto max = [](int x, int y) { return x < y ? y : x; };
+    auto plus = [](int x, int y) { return x + y; };
+    auto fns = std::make_tuple(min, max, plus, f);
+    auto res = multi_fold(fns, 3, 1, 4, 1, 5);
+    CHECK(1, std::get<0>(res));
+    CHECK(5, std::get<1>(res));
+    CHECK(14, std::get<2>(res));
+    CHECK("((((3+1)+4)+1)+5)", std::get<3>(res));
+    CHECK("(((3+1)+(4+1))+5)", std::get<3>(multi_fold<foldt_tag>(fns, 3, 1, 4, 1, 5)));
+    CHECK("(3+(1+(4+(1+5))))", std::get<3>(multi_fold<foldr_tag>(fns, 3, 1, 4, 1, 5)));
+    CHECK("(3+1)", std::get<3>(multi_fold(fns, 3, 1)));
+    CHECK(3, std::get<3>(multi_fold(fns, 3)));
+    CHECK("empty", std::get<0>(multi_fold(std::make_tuple(f))));
+  }
+
+  // batch_fold
+  {
+    int a[] {1, 2, 3};
+    int b[] {4, 5, 6};
+    int c[] {7, 8, 9};
+    std::string out[3];
+    CHECK(out + 3, batch_fold<foldt_tag>(f, 3, out, a, b, c));
+    CHECK("((1+4)+7)", out[0]);
+    CHECK("((2+5)+8)", out[1]);
+    CHECK("((3+6)+9)", out[2]);
+    batch_fold<foldr_tag>(f, 2, out, a, b, c);
+    CHECK("(1+(4+7))", out[0]);
+    CHECK("(2+(5+8))", out[1]);
+    CHECK("((3+6)+9)", out[2]);
+  }
+
+  // scanl / scanr
+  {
+    auto l = scanl(f, 1, 2, 3);
+    CHECK(1, std::get<0>(l));
+    CHECK("(1+2)", std::get<1>(l));
+    CHECK("((1+2)+3)", std::get<2>(l));
+    auto rr = scanr(f, 1, 2, 3);
+    CHECK("(1+(2+3))", std::get<0>(rr));
+    CHECK("(2+3)", std::get<1>(rr));
+    CHECK(3, std::get<2>(rr));
+    CHECK(1, std::get<0>(scanl(f, 1)));
+    CHECK(1, std::get<0>(scanr(f, 1)));
+    static_assert(std::tuple_size<decltype(scanl(f))>::value == 0, "");
+    static_assert(std::tuple_size<decltype(scanr(f))>::value == 0, "");
+  }
+
+  static_assert(foldl_c<CMinus, ic<1>, ic<2>, ic<3>> == -4, "");
+  static_assert(foldr_c<CMinus, ic<1>, ic<2>, ic<3>> == 2, "");
+  static_assert(foldt_c<CMinus, ic<1>, ic<2>, ic<3>, ic<4>, ic<5>> == -5, "");
+  static_assert(foldbl_c<CMinus, ic<1>, ic<2>, ic<3>, ic<4>, ic<5>> == -3, "");
+  static_assert(foldbr_c<CMinus, ic<1>, ic<2>, ic<3>, ic<4>, ic<5>> == -5, "");
+  static_assert(fold_c<foldt_tag, std::plus<>, ic<1>, ic<2>, ic<3>> == 6, "");
+  static_assert(foldl_c<CMinus, ic<1>, ic<2>, ic<3>, ic<4>, ic<5>, ic<6>> == -19, "");
+  static_assert(foldl_c<CMinus, ic<1>> == 1, "");
+  static_assert(&foldt_c<CMinus, ic<1>, ic<2>> == &fold_c<foldt_tag, CMinus, ic<1>, ic<2>>, "");
+  CHECK(-4, (foldl_c<CMinus, ic<1>, ic<2>, ic<3>>));
+#if defined(__cpp_nontype_template_parameter_auto)
+  static_assert(fold_v<foldt_tag, CMinus, 1, 2, 3, 4, 5> == -5, "");
+  static_assert(fold_v<foldl_tag, std::plus<>, 1, 2l> == 3l, "");
+#endif
+
   list<
     int_<1+2+3+4>,
     int_<2+3+4>,
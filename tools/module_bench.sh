@@ -0,0 +1,64 @@
+#!/usr/bin/env bash
+# Full rebuild time of a synthetic project with `#include <falcon/fold.hpp>`
+# versus `import falcon.fold;`.
+#
+# usage: tools/module_bench.sh [number-of-TUs=500] [build-dir=/tmp/falcon_fold_module_bench]
+# env: CXX (g++ or clang++), JOBS (default: nproc), CXXFLAGS
+
+set -e
+
+n=${1:-500}
+dir=${2:-/tmp/falcon_fold_module_bench}
+root=$(cd "$(dirname "$0")/.." && pwd)
+CXX=${CXX:-g++}
+JOBS=${JOBS:-$(nproc)}
+CXXFLAGS="-std=c++20 -O2 -I$root $CXXFLAGS"
+
+case $("$CXX" --version) in
+  *clang*) compiler=clang ;;
+  *) compiler=gcc ;;
+esac
+
+rm -rf "$dir"
+mkdir -p "$dir/include" "$dir/import"
+
+for ((i = 0; i < n; ++i)); do
+  body="
+struct Plus$i
+{
+  constexpr int operator()(int x, int y) const { return x + y * $i; }
+};
+
+int tu_$i(int a, int b, int c, int d, int e)
+{
+  return falcon::foldt(Plus$i{}, a, b, c, d, e)
+       + falcon::foldl(Plus$i{}, a, b, c, d, e, a)
+       + falcon::foldbr(Plus$i{}, e, d, c, b, a, e, d);
+}"
+  printf '#include <falcon/fold.hpp>\n%s\n' "$body" > "$dir/include/tu_$i.cpp"
+  printf 'import falcon.fold;\n%s\n' "$body" > "$dir/import/tu_$i.cpp"
+done
+
+now() { date +%s%N; }
+ms() { echo $(( ($2 - $1) / 1000000 )); }
+
+cd "$dir/include"
+t0=$(now)
+ls tu_*.cpp | xargs -P "$JOBS" -I{} $CXX $CXXFLAGS -c {} -o {}.o
+t1=$(now)
+echo "#include: $n TUs in $(ms $t0 $t1) ms"
+
+cd "$dir/import"
+t0=$(now)
+if [ $compiler = gcc ]; then
+  $CXX $CXXFLAGS -fmodules-ts -x c++ -c "$root/falcon/fold.cppm" -o falcon.fold.o
+  t1=$(now)
+  ls tu_*.cpp | xargs -P "$JOBS" -I{} $CXX $CXXFLAGS -fmodules-ts -c {} -o {}.o
+else
+  $CXX $CXXFLAGS --precompile -x c++-module "$root/falcon/fold.cppm" -o falcon.fold.pcm
+  $CXX $CXXFLAGS -c falcon.fold.pcm -o falcon.fold.o
+  t1=$(now)
+  ls tu_*.cpp | xargs -P "$JOBS" -I{} $CXX $CXXFLAGS -fmodule-file=falcon.fold=falcon.fold.pcm -c {} -o {}.o
+fi
+t2=$(now)
+echo "import:   $n TUs in $(ms $t0 $t2) ms (module interface: $(ms $t0 $t1) ms)"
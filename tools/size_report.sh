@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+# Code size of a synthetic TU with FALCON_FOLD_OPTIMIZE_SIZE=0 and 1:
+# .text size (size -A) and number of fold functions in the object (nm).
+#
+# usage: tools/size_report.sh [max-arity=32] [build-dir=/tmp/falcon_fold_size_report]
+# env: CXX (default: g++), CXXFLAGS, OPT_LEVELS (default: "-O0 -O2 -Os")
+
+set -e
+
+max=${1:-32}
+dir=${2:-/tmp/falcon_fold_size_report}
+root=$(cd "$(dirname "$0")/.." && pwd)
+CXX=${CXX:-g++}
+OPT_LEVELS=${OPT_LEVELS:--O0 -O2 -Os}
+CXXFLAGS="-std=c++14 -I$root $CXXFLAGS"
+
+rm -rf "$dir"
+mkdir -p "$dir"
+src=$dir/size_report.cpp
+
+# fold of a[0], ..., a[n-1] with every shape, for each arity in [3, max]
+# and for int and double (homogeneous) then for int and long (heterogeneous)
+{
+  printf '#include <falcon/fold.hpp>\n\n'
+  printf 'struct Minus\n{\n  template<class T, class U>\n'
+  printf '  auto operator()(T x, U y) const { return x - y; }\n};\n\n'
+  for type in int double; do
+    printf 'double %s_folds(%s const * a)\n{\n  double r = 0;\n' "$type" "$type"
+    for ((n = 3; n <= max; ++n)); do
+      args=a[0]
+      for ((i = 1; i < n; ++i)); do
+        args="$args, a[$i]"
+      done
+      for fold in foldl foldr foldbl foldbr foldt; do
+        printf '  r += falcon::%s(Minus{}, %s);\n' $fold "$args"
+      done
+    done
+    printf '  return r;\n}\n\n'
+  done
+  printf 'long mixed_folds(int const * a, long const * b)\n{\n  long r = 0;\n'
+  for ((n = 3; n <= max; ++n)); do
+    args=a[0]
+    for ((i = 1; i < n; ++i)); do
+      [ $((i % 2)) = 0 ] && args="$args, a[$i]" || args="$args, b[$i]"
+    done
+    for fold in foldl foldt; do
+      printf '  r += falcon::%s(Minus{}, %s);\n' $fold "$args"
+    done
+  done
+  printf '  return r;\n}\n'
+} > "$src"
+
+text_size() {
+  size -A "$1" | awk '$1 ~ /^\.text/ { s += $2 } END { print s + 0 }'
+}
+
+fold_symbols() {
+  nm -C "$1" | grep -c 'falcon::' || true
+}
+
+printf '%-4s %-22s %10s %10s\n' opt mode .text symbols
+for opt in $OPT_LEVELS; do
+  for mode in 0 1; do
+    obj=$dir/size_report$opt-$mode.o
+    $CXX $CXXFLAGS $opt -ffunction-sections -DFALCON_FOLD_OPTIMIZE_SIZE=$mode -c "$src" -o "$obj"
+    printf '%-4s %-22s %10s %10s\n' $opt FALCON_FOLD_OPTIMIZE_SIZE=$mode "$(text_size "$obj")" "$(fold_symbols "$obj")"
+  done
+done